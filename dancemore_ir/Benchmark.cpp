@@ -0,0 +1,346 @@
+/*
+ * Benchmark.cpp - On-device replay benchmark implementation
+ */
+
+#include "Benchmark.h"
+
+#if ENABLE_BENCHMARK
+
+#include "BuildProfile.h"
+#include "ColorPipeline.h"
+#include "DisplayController.h"
+#include "SerialOutput.h"
+
+// Recorded host command stream - one command per line, as sent over serial
+const char BENCH_COMMAND_STREAM[] PROGMEM =
+  "DISP:1234\n"
+  "DISP:HELO\n"
+  "DISP:BRT:5\n"
+  "DISP:0042\n"
+  "LED:ack\n"
+  "LED:fire 5\n"
+  "LED:rainbow 10\n"
+  "LED:thinking 20\n"
+  "LED:red-green-yellow 5\n"
+  "LED:off\n"
+  "DISP:CLR\n";
+
+static uint32_t allocationCount() {
+  return (benchAllocationCount != nullptr) ? benchAllocationCount() : 0;
+}
+
+// Only ns= is a per-rep average. The other columns are totals over every
+// rep: dirty-digit tracking and LED dedup make repeats after the first
+// nearly free, so a per-rep figure would truncate to 0.
+static void printResult(const __FlashStringHelper* kind, const char* label,
+                        unsigned long totalMicros, uint32_t allocations,
+                        uint32_t segments, uint16_t posts, uint32_t txBytes) {
+  Serial.print(F("BENCH "));
+  Serial.print(kind);
+  Serial.print(' ');
+  Serial.print(label);
+  Serial.print(F(" ns="));
+  Serial.print(totalMicros * 1000UL / BENCH_REPETITIONS);
+  Serial.print(F(" reps="));
+  Serial.print(BENCH_REPETITIONS);
+  Serial.print(F(" allocs="));
+  if (benchAllocationCount != nullptr) {
+    Serial.print(allocations);
+  } else {
+    Serial.print(F("n/a"));
+  }
+  Serial.print(F(" seg="));
+  Serial.print(segments);
+  Serial.print(F(" led="));
+  Serial.print(posts);
+  Serial.print(F(" tx="));
+  Serial.println(txBytes);
+}
+
+static void replayCommands(const BenchTarget& target) {
+  char line[32];
+  const char* cursor = BENCH_COMMAND_STREAM;
+
+  while (pgm_read_byte(cursor) != '\0') {
+    // Copy the next recorded line out of flash
+    uint8_t length = 0;
+    char c;
+    while ((c = pgm_read_byte(cursor++)) != '\n' && c != '\0') {
+      if (length < sizeof(line) - 1) line[length++] = c;
+    }
+    line[length] = '\0';
+
+    char label[sizeof(line)];
+    memcpy(label, line, length + 1);
+
+    uint32_t allocationsBefore = allocationCount();
+    uint32_t segmentsBefore = target.segmentBytes();
+    uint16_t postsBefore = ColorPipeline::targetCount();
+    uint32_t txBefore = target.txBytes();
+    unsigned long total = 0;
+
+    for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+      char work[sizeof(line)];
+      memcpy(work, label, length + 1); // Handlers tokenize in place
+      unsigned long start = micros();
+      target.dispatch(work);
+      total += micros() - start;
+      target.drainOutput();
+    }
+
+    printResult(F("cmd"), label, total, allocationCount() - allocationsBefore,
+                target.segmentBytes() - segmentsBefore,
+                ColorPipeline::targetCount() - postsBefore,
+                target.txBytes() - txBefore);
+  }
+}
+
+static void replayIRTrace(const BenchTarget& target) {
+  for (uint8_t i = 0; i < target.irTraceLength; i++) {
+    IREvent event;
+    memcpy_P(&event, &target.irTrace[i], sizeof(IREvent));
+
+    char label[4];
+    itoa(i, label, 10);
+
+    uint32_t allocationsBefore = allocationCount();
+    uint32_t txBefore = target.txBytes();
+    unsigned long total = 0;
+
+    for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+      unsigned long start = micros();
+      target.replayIREvent(event);
+      total += micros() - start;
+      target.drainOutput(); // Keep the TX ring from saturating between reps
+    }
+
+    printResult(F("ir"), label, total, allocationCount() - allocationsBefore, 0, 0,
+                target.txBytes() - txBefore);
+  }
+}
+
+void runReplayBenchmark(const BenchTarget& target) {
+  Serial.print(F("BENCH begin reps="));
+  Serial.println(BENCH_REPETITIONS);
+  target.drainOutput();
+
+  uint16_t pwmBefore = ColorPipeline::pwmWriteCount();
+  unsigned long started = millis();
+
+  replayCommands(target);
+  replayIRTrace(target);
+
+  Serial.print(F("BENCH pwm writes="));
+  Serial.print(ColorPipeline::pwmWriteCount() - pwmBefore);
+  Serial.print(F(" over ms="));
+  Serial.println(millis() - started);
+  Serial.println(F("BENCH end"));
+}
+
+// Cycle counting - Timer1 free-runs at F_CPU, so TCNT1 is a cycle counter.
+// Interrupts are masked between start and stop so Timer0/UART ISRs don't
+// land inside a measurement, which also means TOV1 can only latch one
+// overflow: a window that sets it (65536 cycles, ~4ms, or more) can't be
+// sized and is counted in the ovf column instead of the min/max/mean.
+// Nothing prints inside a window; rows go out with interrupts back on.
+#define CYCLES_OVERFLOW 0xFFFFFFFFUL
+
+struct CycleStats {
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint32_t totalCycles;
+  uint16_t samples;
+  uint16_t overflows;
+};
+
+static uint16_t cycleOverhead;
+static uint8_t cycleSREG;
+
+static inline void startCycles() {
+  cycleSREG = SREG;
+  cli();
+  TIFR1 = _BV(TOV1);
+  TCNT1 = 0;
+}
+
+static inline uint32_t stopCycles() {
+  uint16_t cycles = TCNT1;
+  bool overflowed = TIFR1 & _BV(TOV1);
+  SREG = cycleSREG;
+  if (overflowed) {
+    return CYCLES_OVERFLOW;
+  }
+  return (cycles > cycleOverhead) ? cycles - cycleOverhead : 0;
+}
+
+static void resetCycles(CycleStats& stats) {
+  stats.minCycles = 0xFFFFFFFFUL;
+  stats.maxCycles = 0;
+  stats.totalCycles = 0;
+  stats.samples = 0;
+  stats.overflows = 0;
+}
+
+static void recordCycles(CycleStats& stats, uint32_t cycles) {
+  if (cycles == CYCLES_OVERFLOW) {
+    stats.overflows++;
+    return;
+  }
+  if (cycles < stats.minCycles) stats.minCycles = cycles;
+  if (cycles > stats.maxCycles) stats.maxCycles = cycles;
+  stats.totalCycles += cycles;
+  stats.samples++;
+}
+
+static void printCycles(const __FlashStringHelper* group, const __FlashStringHelper* name,
+                        const CycleStats& stats, uint8_t divisor) {
+  Serial.print(F("CYC,"));
+  Serial.print(group);
+  Serial.print(',');
+  Serial.print(name);
+  Serial.print(',');
+  if (stats.samples > 0) {
+    Serial.print(stats.minCycles / divisor);
+    Serial.print(',');
+    Serial.print(stats.maxCycles / divisor);
+    Serial.print(',');
+    Serial.print(stats.totalCycles / stats.samples / divisor);
+  } else {
+    Serial.print(F(",,")); // Every window overflowed
+  }
+  Serial.print(',');
+  Serial.println(stats.overflows);
+}
+
+// Characters cycled through encodeChar - the display's full supported range
+const char BENCH_ENCODE_CHARS[] PROGMEM = "0123456789 -ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+#define BENCH_ENCODE_COUNT (sizeof(BENCH_ENCODE_CHARS) - 1)
+
+static void cycleEncodeChar() {
+  char text[BENCH_ENCODE_COUNT];
+  memcpy_P(text, BENCH_ENCODE_CHARS, BENCH_ENCODE_COUNT);
+
+  volatile uint8_t sink = 0;
+  CycleStats stats;
+  resetCycles(stats);
+  for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+    startCycles();
+    for (uint8_t i = 0; i < BENCH_ENCODE_COUNT; i++) {
+      sink = DisplayController::encodeChar(text[i]);
+    }
+    recordCycles(stats, stopCycles());
+  }
+  (void)sink;
+  printCycles(F("display"), F("encodeChar/char"), stats, BENCH_ENCODE_COUNT);
+}
+
+static void cycleAppendHex() {
+  LineBuffer line;
+  CycleStats stats;
+  resetCycles(stats);
+  for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+    line.clear();
+    startCycles();
+    line.appendHex(0xF708FB04UL, 8);
+    recordCycles(stats, stopCycles());
+  }
+  printCycles(F("output"), F("appendHex/8digits"), stats, 1);
+}
+
+static void cycleAnimationSteps(LEDAnimations& leds) {
+  for (uint8_t i = 0; i < LEDAnimations::commandCount(); i++) {
+    char args[LED_COMMAND_NAME_MAX + 4];
+    strcpy_P(args, (const char*)LEDAnimations::commandName(i));
+    strcat_P(args, PSTR(" 10"));
+    leds.processCommand(args); // Enter the mode untimed
+
+    CycleStats stats;
+    resetCycles(stats);
+    for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+      startCycles();
+      leds.step();
+      recordCycles(stats, stopCycles());
+    }
+    printCycles(F("anim"), LEDAnimations::commandName(i), stats, 1);
+  }
+}
+
+static void cycleCommandParse(const BenchTarget& target) {
+  for (uint8_t i = 0; i < LEDAnimations::commandCount(); i++) {
+    char line[LED_COMMAND_NAME_MAX + 8];
+    strcpy_P(line, PSTR("LED:"));
+    strcat_P(line, (const char*)LEDAnimations::commandName(i));
+    strcat_P(line, PSTR(" 10"));
+    uint8_t length = strlen(line);
+
+    CycleStats stats;
+    resetCycles(stats);
+    for (uint16_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+      char work[sizeof(line)];
+      memcpy(work, line, length + 1); // Handlers tokenize in place
+      startCycles();
+      target.dispatch(work);
+      recordCycles(stats, stopCycles());
+    }
+    printCycles(F("parse"), LEDAnimations::commandName(i), stats, 1);
+  }
+}
+
+void runCycleBenchmark(const BenchTarget& target) {
+  target.drainOutput();
+
+  // Debug lines from the LED handlers would be written with interrupts
+  // masked, inside the windows being measured
+  bool ledDebug = target.leds->isDebugMode();
+  target.leds->setDebugMode(false);
+
+  // Borrow Timer1 - on the Uno it drives PWM on pins 9 (red) and 10, so
+  // red holds a fixed level until the whole timer state is put back
+  uint8_t savedTCCR1A = TCCR1A;
+  uint8_t savedTCCR1B = TCCR1B;
+  uint8_t savedTIMSK1 = TIMSK1;
+  uint16_t savedTCNT1 = TCNT1;
+  uint16_t savedOCR1A = OCR1A;
+  uint16_t savedOCR1B = OCR1B;
+  uint16_t savedICR1 = ICR1;
+  TIMSK1 = 0;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10); // Normal mode, no prescaler: one count per CPU cycle
+
+  Serial.println(F("CYC,group,name,min,max,mean,ovf"));
+
+  // Calibrate out the cost of the start/stop pair itself
+  cycleOverhead = 0;
+  startCycles();
+  cycleOverhead = stopCycles();
+
+  cycleEncodeChar();
+  cycleAppendHex();
+  cycleAnimationSteps(*target.leds);
+  cycleCommandParse(target);
+
+  // Stop the clock while the registers go back, and drop the flags this
+  // run left behind so a restored interrupt enable doesn't fire on them
+  TCCR1B = 0;
+  TCNT1 = savedTCNT1;
+  OCR1A = savedOCR1A;
+  OCR1B = savedOCR1B;
+  ICR1 = savedICR1;
+  TIFR1 = _BV(ICF1) | _BV(OCF1B) | _BV(OCF1A) | _BV(TOV1);
+  TCCR1A = savedTCCR1A;
+  TIMSK1 = savedTIMSK1;
+  TCCR1B = savedTCCR1B;
+
+  // The pipeline wrote duties against the borrowed timer - replay them
+  // on the restored one before fading to off
+  if (!BuildProfile::ledStrip) {
+    ColorPipeline::rewriteOutputs();
+  }
+  target.leds->off();
+  target.leds->setDebugMode(ledDebug);
+
+  Serial.print(F("CYC,overhead,startstop,"));
+  Serial.println(cycleOverhead);
+}
+
+#endif // ENABLE_BENCHMARK
@@ -0,0 +1,61 @@
+/*
+ * Benchmark.h - On-device replay benchmark for the command and IR paths
+ *
+ * Replays a recorded serial command stream and an IR event trace through
+ * the same dispatch and output code the sketch uses, and reports per-op
+ * cost (ns/op) plus totals over all reps of allocations, framebuffer
+ * bytes changed, LED color posts and TX bytes queued, and PWM writes. Triggered with BENCH:REPLAY, on the
+ * board or in the native build under host/, which also counts mallocs.
+ * On the target the allocs column reads n/a.
+ *
+ * BENCH:CYCLES times the hot paths in CPU cycles with Timer1 running
+ * unprescaled and interrupts masked: every LED animation step, encodeChar,
+ * LineBuffer::appendHex and a full command parse for each LED command.
+ * Output is a CSV table (CYC,group,name,min,max,mean,ovf). Timer1 is
+ * borrowed for the run - pin 9 PWM pauses and is restored afterwards.
+ *
+ * Compiled out unless ENABLE_BENCHMARK is set to 1, so production images
+ * carry none of it.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#ifndef ENABLE_BENCHMARK
+#define ENABLE_BENCHMARK 0
+#endif
+
+#if ENABLE_BENCHMARK
+
+#include <Arduino.h>
+#include "IREventQueue.h"
+#include "LEDAnimations.h"
+
+#ifndef BENCH_REPETITIONS
+#define BENCH_REPETITIONS 8 // The host build raises this for microsecond timer resolution
+#endif
+
+// Allocation counter - defined by the host core, absent (null) on the target
+uint32_t benchAllocationCount() __attribute__((weak));
+
+// Hooks into the sketch - the benchmark itself owns no subsystem
+struct BenchTarget {
+  bool (*dispatch)(char* line);                 // Full command line, prefix included
+  void (*replayIREvent)(const IREvent& event);  // Filter + format + queue one frame
+  void (*drainOutput)();                        // Block until queued output is sent
+  uint32_t (*segmentBytes)();                   // Framebuffer bytes changed so far
+  uint32_t (*txBytes)();                        // TX ring bytes queued so far
+  const IREvent* irTrace;                       // PROGMEM trace
+  uint8_t irTraceLength;
+  LEDAnimations* leds;                          // Stepped directly by BENCH:CYCLES
+};
+
+// Run the recorded command stream and IR trace, printing one line per op
+void runReplayBenchmark(const BenchTarget& target);
+
+// Time the hot paths in CPU cycles, printing one CSV row per function
+void runCycleBenchmark(const BenchTarget& target);
+
+#endif // ENABLE_BENCHMARK
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * BinaryProtocol.cpp - Binary command frame parser implementation
+ */
+
+#include "BinaryProtocol.h"
+
+uint8_t crc8Update(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+FrameParser::FrameParser()
+  : length(0), received(0), seq(0), crc(0), state(STATE_SYNC), lastByteTime(0) {
+}
+
+FrameParser::Result FrameParser::feed(uint8_t c, unsigned long nowMillis) {
+  lastByteTime = nowMillis;
+
+  switch (state) {
+    case STATE_SYNC:
+      if (c == FRAME_SYNC) {
+        state = STATE_LENGTH;
+      }
+      return FRAME_PENDING;
+
+    case STATE_LENGTH:
+      if (c == 0 || c > FRAME_MAX_PAYLOAD) {
+        state = STATE_SYNC; // Not a frame we can hold - resync silently
+        return FRAME_PENDING;
+      }
+      length = c;
+      received = 0;
+      crc = crc8Update(0, c);
+      state = STATE_SEQUENCE;
+      return FRAME_PENDING;
+
+    case STATE_SEQUENCE:
+      seq = c;
+      crc = crc8Update(crc, c);
+      state = STATE_PAYLOAD;
+      return FRAME_PENDING;
+
+    case STATE_PAYLOAD:
+      payload[received++] = c;
+      crc = crc8Update(crc, c);
+      if (received == length) {
+        state = STATE_CRC;
+      }
+      return FRAME_PENDING;
+
+    case STATE_CRC:
+      state = STATE_SYNC;
+      return (c == crc) ? FRAME_COMPLETE : FRAME_ERROR;
+  }
+  return FRAME_PENDING;
+}
+
+void FrameParser::checkTimeout(unsigned long nowMillis) {
+  if (state != STATE_SYNC && nowMillis - lastByteTime > FRAME_TIMEOUT_MS) {
+    state = STATE_SYNC;
+  }
+}
+
+void FrameParser::execute(FrameOpHandler handler) {
+  uint8_t executed = 0;
+  uint8_t status = FRAME_STATUS_OK;
+  uint8_t pos = 0;
+
+  while (pos < length) {
+    if (pos + 2 > length || pos + 2 + payload[pos + 1] > length) {
+      status = FRAME_STATUS_TRUNCATED;
+      break;
+    }
+
+    uint8_t opcode = payload[pos];
+    uint8_t dataLength = payload[pos + 1];
+    if (!handler(opcode, &payload[pos + 2], dataLength)) {
+      status = FRAME_STATUS_BAD_OP;
+      break;
+    }
+
+    executed++;
+    pos += 2 + dataLength;
+  }
+
+  sendAck(status, executed);
+}
+
+void FrameParser::rejectFrame() {
+  sendAck(FRAME_STATUS_BAD_CRC, 0);
+}
+
+void FrameParser::sendAck(uint8_t status, uint8_t executed) {
+  uint8_t ack[5];
+  ack[0] = FRAME_ACK_SYNC;
+  ack[1] = seq;
+  ack[2] = status;
+  ack[3] = executed;
+  ack[4] = crc8Update(crc8Update(crc8Update(0, seq), status), executed);
+  Serial.write(ack, sizeof(ack));
+}
@@ -0,0 +1,85 @@
+/*
+ * BinaryProtocol.h - Length-prefixed, CRC8-checked binary command frames
+ *
+ * Runs alongside the text DISP:/LED: commands. A frame starts with a sync
+ * byte that never appears in text commands, so the serial parser can switch
+ * per frame without a mode command:
+ *
+ *   0xA5 | len | seq | payload[len] | crc8(len, seq, payload)
+ *
+ * The payload is a sequence of ops, each [opcode][data length][data...],
+ * so one frame can carry several display/LED updates. Every frame gets one
+ * batched ACK:
+ *
+ *   0x5A | seq | status | ops executed | crc8(seq, status, ops)
+ */
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <Arduino.h>
+
+#define FRAME_SYNC 0xA5
+#define FRAME_ACK_SYNC 0x5A
+#define FRAME_MAX_PAYLOAD 48
+#define FRAME_TIMEOUT_MS 50 // Drop a partial frame after this much silence
+
+// Opcodes
+#define OP_TEXT_COMMAND   0x01 // data = text command, e.g. "DISP:12" (no newline)
+#define OP_LED_ANIMATION  0x02 // data = animation type, duration seconds (LE16)
+#define OP_LED_MAX_DURATION 32767 // Longer durations are rejected (0 = until replaced)
+#define OP_LED_OFF        0x03 // no data
+#define OP_DISP_SEGMENTS  0x04 // data = 4 raw segment bytes
+#define OP_DISP_BRIGHTNESS 0x05 // data = brightness 0-7
+
+// ACK status codes
+#define FRAME_STATUS_OK        0x00
+#define FRAME_STATUS_BAD_CRC   0x01
+#define FRAME_STATUS_BAD_OP    0x02
+#define FRAME_STATUS_TRUNCATED 0x03
+
+// Executes one op - returns false if the opcode or data is invalid
+typedef bool (*FrameOpHandler)(uint8_t opcode, const uint8_t* data, uint8_t length);
+
+// CRC-8 (poly 0x07) - shared by every checksummed block in the sketch
+uint8_t crc8Update(uint8_t crc, uint8_t data);
+
+class FrameParser {
+public:
+  enum Result : uint8_t { FRAME_PENDING, FRAME_COMPLETE, FRAME_ERROR };
+
+  // Constructor
+  FrameParser();
+
+  // True while a frame is partially received
+  bool isActive() const { return state != STATE_SYNC; }
+
+  // Feed one received byte. The first byte must be FRAME_SYNC.
+  Result feed(uint8_t c, unsigned long nowMillis);
+
+  // Drop a stalled partial frame
+  void checkTimeout(unsigned long nowMillis);
+
+  uint8_t sequence() const { return seq; }
+
+  // Run every op in the completed frame, then send the batched ACK
+  void execute(FrameOpHandler handler);
+
+  // Send the ACK for a frame that failed its CRC
+  void rejectFrame();
+
+private:
+  enum State : uint8_t { STATE_SYNC, STATE_LENGTH, STATE_SEQUENCE, STATE_PAYLOAD, STATE_CRC };
+
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  uint8_t length;
+  uint8_t received;
+  uint8_t seq;
+  uint8_t crc;
+  State state;
+  unsigned long lastByteTime;
+
+  void sendAck(uint8_t status, uint8_t executed);
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * BuildProfile.h - Compile-time feature selection
+ *
+ * Every optional subsystem checks a constexpr flag here instead of (or in
+ * front of) a runtime bool, so a disabled feature is dead code the
+ * compiler drops along with the PROGMEM tables only it references.
+ * Pick a profile by changing the default below, or with
+ * -DBUILD_PROFILE=BUILD_PROFILE_LEAN in the build flags. The LED output
+ * backend is chosen the same way with LED_OUTPUT.
+ *
+ * FULL: everything, debug mode selected at boot by the pin 10 jumper.
+ * LEAN: production units - no debug output or help tables, keyframe LED
+ *       effects only, no display effects or marquee.
+ */
+
+#ifndef BUILD_PROFILE_H
+#define BUILD_PROFILE_H
+
+#define BUILD_PROFILE_FULL 0
+#define BUILD_PROFILE_LEAN 1
+
+#ifndef BUILD_PROFILE
+#define BUILD_PROFILE BUILD_PROFILE_FULL
+#endif
+
+// LED output backend: the single PWM RGB LED, or a WS2812 strip (LEDStrip.h)
+#define LED_OUTPUT_PWM 0
+#define LED_OUTPUT_STRIP 1
+
+#ifndef LED_OUTPUT
+#define LED_OUTPUT LED_OUTPUT_PWM
+#endif
+
+struct BuildProfile {
+  // Debug banner, per-frame debug lines and module chatter
+  static constexpr bool debugOutput = (BUILD_PROFILE == BUILD_PROFILE_FULL);
+
+  // Computed LED effects (matrix, rainbow, pulses, fire, ocean) and their
+  // sine/rainbow tables; keyframe effects and LED:custom always stay
+  static constexpr bool computedLedEffects = (BUILD_PROFILE == BUILD_PROFILE_FULL);
+
+  // DISP:ANIM: effects and the DISP:SCROLL: marquee
+  static constexpr bool displayEffects = (BUILD_PROFILE == BUILD_PROFILE_FULL);
+
+  // LEDAnimations renders into the strip framebuffer instead of ColorPipeline
+  static constexpr bool ledStrip = (LED_OUTPUT == LED_OUTPUT_STRIP);
+
+  // Gate a runtime debug flag - folds to false when debug output is compiled out
+  static constexpr bool debug(bool runtimeFlag) { return debugOutput && runtimeFlag; }
+};
+
+#endif
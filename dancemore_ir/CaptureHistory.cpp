@@ -0,0 +1,112 @@
+/*
+ * CaptureHistory.cpp - Capture ring implementation
+ */
+
+#include "CaptureHistory.h"
+
+CaptureHistory::CaptureHistory() : nextSequence(0) {
+  clear();
+}
+
+// Sequence numbers keep running, so readers see the cleared records as overwritten
+void CaptureHistory::clear() {
+  stored = 0;
+  lastCaptureMicros = 0;
+  memset(indexSlots, CAPTURE_NONE, sizeof(indexSlots));
+}
+
+uint8_t CaptureHistory::hashKey(uint16_t address, uint16_t command) {
+  // Same mix as the macro table - commands vary fastest
+  uint16_t h = command * 31 + address * 7;
+  return (uint8_t)(h ^ (h >> 8)) & (CAPTURE_INDEX_SLOTS - 1);
+}
+
+uint8_t CaptureHistory::findSlot(uint16_t address, uint16_t command) const {
+  uint8_t slot = hashKey(address, command);
+
+  // Linear probe until a hit or an empty slot (table is never full)
+  while (indexSlots[slot] != CAPTURE_NONE) {
+    const CaptureRecord& record = records[indexSlots[slot]];
+    if (record.address == address && record.command == command) {
+      return slot;
+    }
+    slot = (slot + 1) & (CAPTURE_INDEX_SLOTS - 1);
+  }
+  return slot;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+void CaptureHistory::removeSlot(uint8_t slot) {
+  uint8_t next = slot;
+  for (;;) {
+    next = (next + 1) & (CAPTURE_INDEX_SLOTS - 1);
+    uint8_t position = indexSlots[next];
+    if (position == CAPTURE_NONE) {
+      break;
+    }
+    uint8_t home = hashKey(records[position].address, records[position].command);
+    // Move the entry back unless its home lies cyclically in (slot, next]
+    if (((next - home) & (CAPTURE_INDEX_SLOTS - 1)) >= ((next - slot) & (CAPTURE_INDEX_SLOTS - 1))) {
+      indexSlots[slot] = position;
+      slot = next;
+    }
+  }
+  indexSlots[slot] = CAPTURE_NONE;
+}
+
+void CaptureHistory::indexRecord(uint8_t position) {
+  const CaptureRecord& record = records[position];
+  uint8_t slot = findSlot(record.address, record.command);
+  uint8_t newest = indexSlots[slot];
+  codeCounts[position] = (newest == CAPTURE_NONE) ? 1 : codeCounts[newest] + 1;
+  indexSlots[slot] = position;
+}
+
+void CaptureHistory::unindexRecord(uint8_t position) {
+  const CaptureRecord& record = records[position];
+  uint8_t slot = findSlot(record.address, record.command);
+  uint8_t newest = indexSlots[slot];
+  // The oldest copy going means one fewer; the last copy is the newest one
+  if (--codeCounts[newest] == 0) {
+    removeSlot(slot);
+  }
+}
+
+void CaptureHistory::push(uint8_t protocol, uint8_t flags, uint16_t address, uint16_t command,
+                          unsigned long captureMicros) {
+  uint8_t position = nextSequence & (CAPTURE_HISTORY_SIZE - 1);
+  if (stored == CAPTURE_HISTORY_SIZE) {
+    unindexRecord(position);
+  }
+
+  CaptureRecord& record = records[position];
+  record.protocol = protocol;
+  record.flags = flags;
+  record.address = address;
+  record.command = command;
+
+  unsigned long deltaMillis = stored > 0 ? (captureMicros - lastCaptureMicros) / 1000UL : 0;
+  record.deltaMillis = deltaMillis > 0xFFFF ? 0xFFFF : (uint16_t)deltaMillis;
+  lastCaptureMicros = captureMicros;
+
+  indexRecord(position);
+
+  nextSequence++;
+  if (stored < CAPTURE_HISTORY_SIZE) {
+    stored++;
+  }
+}
+
+bool CaptureHistory::get(uint16_t sequence, CaptureRecord& record) const {
+  // Unsigned distance handles sequence wrap-around
+  if ((uint16_t)(sequence - firstSequence()) >= stored) {
+    return false;
+  }
+  record = records[sequence & (CAPTURE_HISTORY_SIZE - 1)];
+  return true;
+}
+
+uint8_t CaptureHistory::countOf(uint16_t address, uint16_t command) const {
+  uint8_t newest = indexSlots[findSlot(address, command)];
+  return (newest == CAPTURE_NONE) ? 0 : codeCounts[newest];
+}
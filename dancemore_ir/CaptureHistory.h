@@ -0,0 +1,73 @@
+/*
+ * CaptureHistory.h - In-RAM ring of recently decoded IR frames
+ *
+ * Keeps the last CAPTURE_HISTORY_SIZE valid frames as packed 8-byte
+ * records so they can be replayed to the host later (EXPORT:DUMP) instead
+ * of only existing as lines that already scrolled past on serial.
+ *
+ * Records are addressed by a running sequence number rather than a ring
+ * index, so a reader walking the history notices when the writer has
+ * lapped it and skips the overwritten records.
+ *
+ * A small hash index keyed on {address, command} points at the newest
+ * record of each code and holds how many copies are in the ring, so
+ * HIST:COUNT answers without a scan. Evicting the oldest record
+ * decrements its code and drops the entry once the count reaches zero.
+ */
+
+#ifndef CAPTURE_HISTORY_H
+#define CAPTURE_HISTORY_H
+
+#include <Arduino.h>
+
+#define CAPTURE_HISTORY_SIZE 32 // Power of 2 - indices wrap with a mask
+#define CAPTURE_INDEX_SLOTS 64  // Power of 2, at most half full
+#define CAPTURE_NONE 0xFF
+
+struct CaptureRecord {
+  uint8_t protocol;  // IRremote decode_type_t
+  uint8_t flags;     // IRremote IRDATA_FLAGS_* as decoded
+  uint16_t address;
+  uint16_t command;
+  uint16_t deltaMillis; // Since the previous record, saturates at 0xFFFF
+};
+
+class CaptureHistory {
+private:
+  CaptureRecord records[CAPTURE_HISTORY_SIZE];
+  uint16_t nextSequence;       // Sequence number of the next push
+  uint8_t stored;              // Valid records, up to CAPTURE_HISTORY_SIZE
+  unsigned long lastCaptureMicros;
+
+  uint8_t indexSlots[CAPTURE_INDEX_SLOTS]; // Newest record of a code, or CAPTURE_NONE
+  uint8_t codeCounts[CAPTURE_HISTORY_SIZE]; // Copies of the code, kept on its newest record
+
+  static uint8_t hashKey(uint16_t address, uint16_t command);
+  uint8_t findSlot(uint16_t address, uint16_t command) const;
+  void removeSlot(uint8_t slot);
+  void indexRecord(uint8_t position);
+  void unindexRecord(uint8_t position);
+
+public:
+  // Constructor
+  CaptureHistory();
+
+  // Append a frame, overwriting the oldest once full
+  void push(uint8_t protocol, uint8_t flags, uint16_t address, uint16_t command,
+            unsigned long captureMicros);
+
+  void clear();
+
+  // Sequence numbers [firstSequence(), endSequence()) are currently held
+  uint16_t firstSequence() const { return nextSequence - stored; }
+  uint16_t endSequence() const { return nextSequence; }
+  uint8_t count() const { return stored; }
+
+  // Copy out one record - false if it was overwritten or not written yet
+  bool get(uint16_t sequence, CaptureRecord& record) const;
+
+  // Records of this code currently held (any protocol)
+  uint8_t countOf(uint16_t address, uint16_t command) const;
+};
+
+#endif
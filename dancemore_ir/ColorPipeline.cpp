@@ -0,0 +1,147 @@
+/*
+ * ColorPipeline.cpp - Interrupt-driven RGB LED output implementation
+ */
+
+#include "ColorPipeline.h"
+#include "FixedPoint.h"
+
+volatile uint8_t ColorPipeline::pendingColor[3];
+volatile uint16_t ColorPipeline::pendingStep;
+volatile bool ColorPipeline::pendingReady = false;
+
+uint8_t ColorPipeline::startColor[3];
+uint8_t ColorPipeline::targetColor[3];
+uint8_t ColorPipeline::currentColor[3];
+uint8_t ColorPipeline::writtenDuty[3];
+uint16_t ColorPipeline::phase = 0xFFFF;
+uint16_t ColorPipeline::step = 0;
+uint8_t ColorPipeline::tickDivider = 0;
+
+uint16_t ColorPipeline::targetsPosted = 0;
+volatile uint16_t ColorPipeline::pwmWrites = 0;
+
+uint8_t ColorPipeline::pins[3];
+bool ColorPipeline::commonAnode = true;
+
+// Perceptual brightness correction: (i / 255) ^ 2.2 * 255
+// Keeps low-level sine steps (matrix, ocean, pulse) from jumping visibly
+const uint8_t ColorPipeline::gammaTable[256] PROGMEM = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+    3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+    6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+   12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+   20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+   30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+   42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+   56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+   73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+   91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+  113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+  137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+  163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+  192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+  223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+void ColorPipeline::begin(uint8_t redPin, uint8_t greenPin, uint8_t bluePin, bool commonAnode) {
+  pins[0] = redPin;
+  pins[1] = greenPin;
+  pins[2] = bluePin;
+  ColorPipeline::commonAnode = commonAnode;
+
+  for (uint8_t c = 0; c < 3; c++) {
+    pinMode(pins[c], OUTPUT);
+    startColor[c] = targetColor[c] = currentColor[c] = 0;
+    writtenDuty[c] = 0xFF; // Force the first write
+  }
+  phase = 0xFFFF;
+  writeOutputs();
+
+  // Timer0 compare B fires once per Timer0 overflow period; Arduino only
+  // uses OCR0B for analogWrite() on pin 5, which is not an LED pin here
+  OCR0B = 0x80;
+  TIMSK0 |= _BV(OCIE0B);
+}
+
+void ColorPipeline::setTarget(uint8_t red, uint8_t green, uint8_t blue, uint16_t fadeStep) {
+  pendingReady = false;
+  pendingColor[0] = red;
+  pendingColor[1] = green;
+  pendingColor[2] = blue;
+  pendingStep = fadeStep;
+  pendingReady = true;
+  targetsPosted++;
+}
+
+uint16_t ColorPipeline::pwmWriteCount() {
+  // 16-bit counter written by the ISR - read with interrupts masked
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t count = pwmWrites;
+  SREG = oldSREG;
+  return count;
+}
+
+void ColorPipeline::writeOutputs() {
+  for (uint8_t c = 0; c < 3; c++) {
+    uint8_t duty = pgm_read_byte(&gammaTable[currentColor[c]]);
+    if (commonAnode) {
+      duty = 255 - duty;
+    }
+    if (duty != writtenDuty[c]) {
+      analogWrite(pins[c], duty);
+      writtenDuty[c] = duty;
+      pwmWrites++;
+    }
+  }
+}
+
+void ColorPipeline::rewriteOutputs() {
+  // writtenDuty is ISR-owned - keep the ISR out while it is replayed
+  uint8_t oldSREG = SREG;
+  cli();
+  for (uint8_t c = 0; c < 3; c++) {
+    analogWrite(pins[c], writtenDuty[c]);
+  }
+  SREG = oldSREG;
+}
+
+void ColorPipeline::tick() {
+  // Halve the ~976 Hz Timer0 rate
+  if (++tickDivider & 0x01) {
+    return;
+  }
+
+  if (pendingReady) {
+    for (uint8_t c = 0; c < 3; c++) {
+      startColor[c] = currentColor[c];
+      targetColor[c] = pendingColor[c];
+    }
+    step = pendingStep;
+    phase = (step == 0) ? 0xFFFF : 0;
+    pendingReady = false;
+  } else if (phase == 0xFFFF) {
+    return; // Settled - nothing to do
+  } else {
+    phase = (0xFFFF - phase <= step) ? 0xFFFF : phase + step;
+  }
+
+  if (phase == 0xFFFF) {
+    for (uint8_t c = 0; c < 3; c++) {
+      currentColor[c] = targetColor[c];
+    }
+  } else {
+    // Linear blend with an 8-bit fraction: multiply and shift, no divide
+    uint8_t fraction = phase >> 8;
+    for (uint8_t c = 0; c < 3; c++) {
+      currentColor[c] = lerp8(startColor[c], targetColor[c], fraction);
+    }
+  }
+
+  writeOutputs();
+}
+
+ISR(TIMER0_COMPB_vect) {
+  ColorPipeline::tick();
+}
@@ -0,0 +1,75 @@
+/*
+ * ColorPipeline.h - Interrupt-driven RGB LED output with gamma-corrected fades
+ *
+ * Animations post a target color; a timer interrupt (~488 Hz, piggybacked on
+ * Timer0 compare B so millis() is untouched) interpolates linearly from the
+ * current color to the target and writes the gamma-corrected PWM duty.
+ * Coarse animation steps therefore render as smooth fades without calling
+ * LEDAnimations::update() more often.
+ */
+
+#ifndef COLOR_PIPELINE_H
+#define COLOR_PIPELINE_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// Timer0 overflows every 1024us on a 16 MHz part; the ISR works every 2nd one
+#define COLOR_PIPELINE_TICK_US 2048UL
+
+// Convert a fade duration to the per-tick phase increment (0 = snap)
+constexpr uint16_t colorFadeStep(uint16_t fadeMillis) {
+  return (fadeMillis == 0) ? 0
+       : (fadeMillis * 1000UL <= COLOR_PIPELINE_TICK_US) ? 0xFFFF
+       : (uint16_t)((COLOR_PIPELINE_TICK_US * 0xFFFFUL) / (fadeMillis * 1000UL));
+}
+
+class ColorPipeline {
+private:
+  // Pending target written by the main loop, latched by the ISR.
+  // The main loop clears pendingReady before writing, so the ISR never
+  // observes a half-written target.
+  static volatile uint8_t pendingColor[3];
+  static volatile uint16_t pendingStep;
+  static volatile bool pendingReady;
+
+  // ISR-owned interpolation state
+  static uint8_t startColor[3];
+  static uint8_t targetColor[3];
+  static uint8_t currentColor[3];
+  static uint8_t writtenDuty[3];
+  static uint16_t phase; // 0..0xFFFF across the fade
+  static uint16_t step;
+  static uint8_t tickDivider;
+
+  static uint8_t pins[3];
+  static bool commonAnode;
+
+  static const uint8_t gammaTable[256];
+
+  // Instrumentation counters (read by the benchmark)
+  static uint16_t targetsPosted;
+  static volatile uint16_t pwmWrites;
+
+  static void writeOutputs();
+
+public:
+  // Configure pins and enable the interrupt. Common anode inverts duty.
+  static void begin(uint8_t redPin, uint8_t greenPin, uint8_t bluePin, bool commonAnode = true);
+
+  // Post a new target color; fadeStep from colorFadeStep() (0 = snap)
+  static void setTarget(uint8_t red, uint8_t green, uint8_t blue, uint16_t fadeStep);
+
+  // Interpolation step - called from the timer interrupt only
+  static void tick();
+
+  // Re-issue the last written duty on every pin - after something else
+  // reconfigured the PWM timers (BENCH:CYCLES borrows Timer1)
+  static void rewriteOutputs();
+
+  // Counters for the benchmark: setTarget() calls and analogWrite() calls
+  static uint16_t targetCount() { return targetsPosted; }
+  static uint16_t pwmWriteCount();
+};
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * CommandRegistry.cpp - Zero-allocation serial command dispatch implementation
+ */
+
+#include "CommandRegistry.h"
+
+bool dispatchCommand(char* line, const CommandRoute* routes, uint8_t numRoutes) {
+  for (uint8_t i = 0; i < numRoutes; i++) {
+    const char* prefix = routes[i].prefix; // PROGMEM address
+    size_t prefixLength = strlen_P(prefix);
+
+    if (strncasecmp_P(line, prefix, prefixLength) == 0) {
+      CommandHandler handler = (CommandHandler)pgm_read_ptr(&routes[i].handler);
+      return handler(line + prefixLength);
+    }
+  }
+  return false;
+}
+
+char* nextToken(char*& cursor, char delimiter) {
+  char* token = cursor;
+  while (*cursor != '\0' && *cursor != delimiter) {
+    cursor++;
+  }
+  if (*cursor == delimiter) {
+    *cursor++ = '\0';
+  }
+  return token;
+}
+
+void upcaseInPlace(char* text) {
+  for (; *text != '\0'; text++) {
+    *text = toupper(*text);
+  }
+}
@@ -0,0 +1,39 @@
+/*
+ * CommandRegistry.h - Zero-allocation serial command dispatch
+ *
+ * Routes a null-terminated command line to a handler by prefix
+ * (e.g. "DISP:", "LED:") using a PROGMEM route table and function pointers.
+ * The prefix is matched once and the handler receives a pointer into the
+ * same buffer, so no String objects are created on the command path.
+ */
+
+#ifndef COMMAND_REGISTRY_H
+#define COMMAND_REGISTRY_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+#define COMMAND_PREFIX_MAX 12 // Longest prefix ("DISP:ANIM:") including terminator
+
+// Handler receives the text after the prefix; it may modify it in place.
+// Returns true if the command was consumed.
+typedef bool (*CommandHandler)(char* args);
+
+// Route entry - store tables of these in PROGMEM
+struct CommandRoute {
+  char prefix[COMMAND_PREFIX_MAX];
+  CommandHandler handler;
+};
+
+// Dispatch a command line through a PROGMEM route table.
+// Prefix match is case-insensitive. Returns true if a handler consumed it.
+bool dispatchCommand(char* line, const CommandRoute* routes, uint8_t numRoutes);
+
+// Split off the next token in place: terminates it at the delimiter and
+// advances cursor past it. Returns the token (empty string at end of input).
+char* nextToken(char*& cursor, char delimiter);
+
+// Uppercase a buffer in place
+void upcaseInPlace(char* text);
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * DisplayAnimations.cpp - Non-blocking TM1637 effects implementation
+ */
+
+#include "DisplayAnimations.h"
+#include "BuildProfile.h"
+#include "TaskScheduler.h"
+
+// Effect table - intervals match the delay() values of the original sketch
+const DisplayAnimationInfo displayAnimationTable[] PROGMEM = {
+  {"spinner", DISP_ANIM_SPINNER, 80},
+  {"wave", DISP_ANIM_WAVE, 60},
+  {"dots", DISP_ANIM_DOTS, 150},
+  {"sweep", DISP_ANIM_SWEEP, 50},
+  {"rotate", DISP_ANIM_ROTATE, 100}
+};
+
+const uint8_t NUM_DISPLAY_ANIMATIONS = sizeof(displayAnimationTable) / sizeof(displayAnimationTable[0]);
+
+// Frame tables - one segment pattern per step
+const uint8_t spinnerFrames[] PROGMEM = {
+  0b00000001, 0b00000010, 0b00000100, 0b00001000, 0b00010000, 0b00100000
+};
+
+const uint8_t waveFrames[] PROGMEM = {
+  0b00001000, 0b00000100, 0b00000010, 0b00000001, 0b00100000, 0b00010000
+};
+
+#define SPINNER_FRAME_COUNT sizeof(spinnerFrames)
+#define WAVE_FRAME_COUNT sizeof(waveFrames)
+#define DOTS_SEGMENT 0b10000000
+#define SWEEP_SEGMENTS 7
+#define SWEEP_PAUSE_STEPS 6 // 300ms hold at the sweep interval
+
+DisplayAnimations::DisplayAnimations(DisplayController& display)
+  : display(display), mode(DISP_ANIM_OFF), animationEndTime(0), lastAnimationUpdate(0),
+    animationInterval(100), animationStep(0), debugMode(false) {
+}
+
+void DisplayAnimations::begin(bool debugMode) {
+  this->debugMode = debugMode;
+}
+
+void DisplayAnimations::start(DisplayAnimationMode mode, uint16_t durationSeconds) {
+  start(mode, durationSeconds, millis());
+}
+
+void DisplayAnimations::start(DisplayAnimationMode mode, uint16_t durationSeconds,
+                              unsigned long now) {
+  if (mode == DISP_ANIM_OFF) {
+    stop();
+    display.clear();
+    return;
+  }
+  if (!BuildProfile::displayEffects) {
+    return; // Compiled out - scenes still drive their LED half
+  }
+
+  this->mode = mode;
+  animationStep = 0;
+  animationInterval = 100;
+  for (uint8_t i = 0; i < NUM_DISPLAY_ANIMATIONS; i++) {
+    if (pgm_read_byte(&displayAnimationTable[i].mode) == mode) {
+      animationInterval = pgm_read_word(&displayAnimationTable[i].intervalMillis);
+      break;
+    }
+  }
+
+  animationEndTime = (durationSeconds > 0) ? now + durationSeconds * 1000UL : 0;
+  lastAnimationUpdate = now;
+  step(); // First frame immediately
+}
+
+void DisplayAnimations::stop() {
+  mode = DISP_ANIM_OFF;
+  animationEndTime = 0;
+}
+
+void DisplayAnimations::update() {
+  update(millis());
+}
+
+void DisplayAnimations::update(unsigned long currentTime) {
+  if (!BuildProfile::displayEffects || mode == DISP_ANIM_OFF) {
+    return;
+  }
+
+  // Check if the effect should end
+  if (animationEndTime > 0 && (long)(currentTime - animationEndTime) >= 0) {
+    stop();
+    display.clear();
+    return;
+  }
+
+  if (!stepCadence(lastAnimationUpdate, currentTime, animationInterval)) {
+    return;
+  }
+
+  step();
+}
+
+// Segments of one digit during the sweep: fill bit by bit across the
+// digits, hold, then clear bit by bit in the same order
+uint8_t DisplayAnimations::sweepSegments(uint8_t digit, uint8_t width) {
+  uint16_t phaseSteps = SWEEP_SEGMENTS * width;
+  uint16_t s = animationStep;
+
+  if (s < phaseSteps) {
+    uint8_t segment = s / width;
+    uint8_t filled = (1 << segment) - 1;
+    return (digit <= s % width) ? (filled | (1 << segment)) : filled;
+  }
+
+  s -= phaseSteps;
+  if (s < SWEEP_PAUSE_STEPS) {
+    return (1 << SWEEP_SEGMENTS) - 1;
+  }
+
+  s -= SWEEP_PAUSE_STEPS;
+  uint8_t segment = s / width;
+  uint8_t cleared = (2 << segment) - 1;
+  uint8_t remaining = (digit <= s % width) ? ~cleared : ~(cleared >> 1);
+  return remaining & ((1 << SWEEP_SEGMENTS) - 1);
+}
+
+void DisplayAnimations::step() {
+  uint8_t width = display.digitCount();
+  uint16_t cycleLength = 1;
+
+  for (uint8_t digit = 0; digit < width; digit++) {
+    uint8_t segments = 0;
+
+    switch (mode) {
+      case DISP_ANIM_SPINNER:
+        segments = pgm_read_byte(&spinnerFrames[animationStep]);
+        cycleLength = SPINNER_FRAME_COUNT;
+        break;
+
+      case DISP_ANIM_WAVE: // One full chase per digit, then move right
+        if (digit == animationStep / WAVE_FRAME_COUNT) {
+          segments = pgm_read_byte(&waveFrames[animationStep % WAVE_FRAME_COUNT]);
+        }
+        cycleLength = WAVE_FRAME_COUNT * width;
+        break;
+
+      case DISP_ANIM_DOTS:
+        segments = (digit == animationStep) ? DOTS_SEGMENT : 0;
+        cycleLength = width;
+        break;
+
+      case DISP_ANIM_SWEEP:
+        segments = sweepSegments(digit, width);
+        cycleLength = 2 * SWEEP_SEGMENTS * width + SWEEP_PAUSE_STEPS;
+        break;
+
+      case DISP_ANIM_ROTATE:
+        segments = DisplayController::encodeChar('0' + animationStep);
+        cycleLength = 10;
+        break;
+
+      default:
+        break;
+    }
+
+    display.displayDigit(digit, segments);
+  }
+
+  animationStep++;
+  if (animationStep >= cycleLength) {
+    animationStep = 0;
+  }
+}
+
+// DISP:ANIM:<name> [seconds] - DISP:ANIM:off stops and clears
+bool DisplayAnimations::processCommand(char* args) {
+  if (!BuildProfile::displayEffects) {
+    return false;
+  }
+
+  char* cursor = args;
+  char* name = nextToken(cursor, ' ');
+  uint16_t duration = atoi(cursor);
+
+  if (strcasecmp_P(name, PSTR("off")) == 0) {
+    start(DISP_ANIM_OFF, 0);
+    return true;
+  }
+
+  for (uint8_t i = 0; i < NUM_DISPLAY_ANIMATIONS; i++) {
+    if (strcasecmp_P(name, displayAnimationTable[i].name) == 0) {
+      start((DisplayAnimationMode)pgm_read_byte(&displayAnimationTable[i].mode), duration);
+      if (BuildProfile::debug(debugMode)) {
+        Serial.print(F("Display animation started: "));
+        Serial.println(name);
+      }
+      return true;
+    }
+  }
+
+  if (BuildProfile::debug(debugMode)) {
+    printHelp();
+  }
+  return true;
+}
+
+void DisplayAnimations::printHelp() {
+  Serial.println(F("Display animations:"));
+  for (uint8_t i = 0; i < NUM_DISPLAY_ANIMATIONS; i++) {
+    Serial.print(F("  DISP:ANIM:"));
+    Serial.print((const __FlashStringHelper*)displayAnimationTable[i].name);
+    Serial.println(F(" [seconds]"));
+  }
+  Serial.println(F("  DISP:ANIM:off"));
+}
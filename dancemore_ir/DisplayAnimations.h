@@ -0,0 +1,77 @@
+/*
+ * DisplayAnimations.h
+ * Non-blocking TM1637 effects (ported from the tm1637_animations sketch)
+ *
+ * Each effect is an interval plus a step counter, advanced from update()
+ * the same way LEDAnimations drives the RGB LED, so the display can show a
+ * busy spinner while IR capture and serial handling keep running.
+ * Frames are written through DisplayController, which only transmits the
+ * digits that changed. Effects span every chained module.
+ */
+
+#ifndef DISPLAY_ANIMATIONS_H
+#define DISPLAY_ANIMATIONS_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "DisplayController.h"
+
+enum DisplayAnimationMode {
+  DISP_ANIM_OFF,
+  DISP_ANIM_SPINNER,  // Segment chase on every digit
+  DISP_ANIM_WAVE,     // Segment chase travelling left to right
+  DISP_ANIM_DOTS,     // Decimal point walking across the digits
+  DISP_ANIM_SWEEP,    // Fill segments digit by digit, pause, then empty
+  DISP_ANIM_ROTATE    // Count 0-9 on every digit
+};
+
+#define DISPLAY_ANIM_NAME_MAX 8 // Longest name ("spinner") + terminator
+
+// Effect table entry - lives in PROGMEM like LEDCommand
+struct DisplayAnimationInfo {
+  char name[DISPLAY_ANIM_NAME_MAX];
+  uint8_t mode;
+  uint16_t intervalMillis;
+};
+
+class DisplayAnimations {
+private:
+  DisplayController& display;
+
+  DisplayAnimationMode mode;
+  unsigned long animationEndTime; // 0 = run until stopped
+  unsigned long lastAnimationUpdate;
+  uint16_t animationInterval;
+  uint16_t animationStep;
+  bool debugMode;
+
+  // Render the frame for animationStep and advance it
+  void step();
+  uint8_t sweepSegments(uint8_t digit, uint8_t width);
+
+public:
+  explicit DisplayAnimations(DisplayController& display);
+
+  void begin(bool debugMode = false);
+
+  // Advance the running effect; call from a scheduler task
+  void update();
+  void update(unsigned long now); // Shared timebase from SceneEngine
+
+  // durationSeconds 0 = loop until stopped or replaced
+  void start(DisplayAnimationMode mode, uint16_t durationSeconds);
+  void start(DisplayAnimationMode mode, uint16_t durationSeconds, unsigned long now);
+
+  // Override the effect's default step interval (scenes lock it to the LED)
+  void setInterval(uint16_t intervalMillis) { animationInterval = intervalMillis; }
+
+  // End the effect without touching the display (new content follows)
+  void stop();
+  bool isAnimating() { return mode != DISP_ANIM_OFF; }
+
+  // Command processing (text after the "DISP:ANIM:" prefix, tokenized in place)
+  bool processCommand(char* args);
+  void printHelp();
+};
+
+#endif
@@ -3,80 +3,275 @@
  */
 
 #include "DisplayController.h"
+#include "BuildProfile.h"
+#include "TaskScheduler.h"
+
+// Bus phase interval used by flush(); matches the TM1637 library's bit delay
+#define DISPLAY_FLUSH_STEP_US 50
 
 DisplayController::DisplayController(int clkPin, int dioPin, bool debug) 
-    : display(clkPin, dioPin), displayBrightness(4), displayEnabled(true), debugMode(debug) {
+    : bus(clkPin, dioPin), displayBrightness(4), displayEnabled(true), debugMode(debug),
+      moduleCount(1), nextModule(0), segmentBytesChanged(0), scrollLength(0),
+      scrollOffset(0), scrollIntervalMillis(DISPLAY_SCROLL_DEFAULT_MS), lastScrollStep(0) {
+    moduleDio[0] = dioPin;
+    memset(framebuffer, 0, sizeof(framebuffer));
+    memset(dirtyDigits, 0, sizeof(dirtyDigits));
+}
+
+bool DisplayController::addModule(uint8_t dioPin) {
+    if (moduleCount >= DISPLAY_MAX_MODULES) {
+        return false;
+    }
+    moduleDio[moduleCount++] = dioPin;
+    return true;
+}
+
+void DisplayController::begin(bool startupPattern) {
+    // Configure the shared CLK plus every module's DIO line
+    for (uint8_t module = 0; module < moduleCount; module++) {
+        bus.selectDio(moduleDio[module]);
+        bus.begin();
+        dirtyDigits[module] = (1 << TM1637_DIGITS) - 1; // Contents unknown at power-up
+    }
+    clear();
+    flush();
+    if (startupPattern) {
+        showStartupPattern();
+    }
+}
+
+void DisplayController::update() {
+    if (!bus.isIdle()) {
+        bus.step();
+        return;
+    }
+
+    // Round-robin over the modules so a busy one can't starve the rest;
+    // each transmit carries only the changed digits of one module
+    for (uint8_t n = 0; n < moduleCount; n++) {
+        uint8_t module = nextModule;
+        nextModule = (nextModule + 1 < moduleCount) ? nextModule + 1 : 0;
+
+        uint8_t dirty = dirtyDigits[module];
+        if (dirty == 0) {
+            continue;
+        }
+
+        // Send the smallest contiguous run covering every dirty digit
+        uint8_t first = 0;
+        while (!(dirty & (1 << first))) first++;
+        uint8_t last = TM1637_DIGITS - 1;
+        while (!(dirty & (1 << last))) last--;
+
+        bus.selectDio(moduleDio[module]);
+        bus.beginWrite(&framebuffer[module][first], first, last - first + 1, controlByte());
+        dirtyDigits[module] = 0;
+        bus.step();
+        return;
+    }
+}
+
+void DisplayController::scrollText(const char* text, uint16_t intervalMillis) {
+    if (!BuildProfile::displayEffects || !displayEnabled) return;
+
+    // Encode the whole message once; frames only copy from this buffer
+    scrollLength = 0;
+    for (; *text != '\0' && scrollLength < DISPLAY_SCROLL_MAX; text++) {
+        scrollSegments[scrollLength++] = encodeChar(*text);
+    }
+    if (scrollLength == 0) return;
+
+    scrollIntervalMillis = (intervalMillis > 0) ? intervalMillis : DISPLAY_SCROLL_DEFAULT_MS;
+    scrollOffset = 0;
+    lastScrollStep = millis();
+    renderScrollWindow();
+}
+
+void DisplayController::stopScroll() {
+    scrollLength = 0;
+}
+
+void DisplayController::updateScroll(unsigned long now) {
+    if (!BuildProfile::displayEffects || scrollLength == 0 || !displayEnabled) {
+        return;
+    }
+
+    if (!stepCadence(lastScrollStep, now, scrollIntervalMillis)) {
+        return;
+    }
+
+    // Text enters from the right and leaves on the left, then repeats
+    scrollOffset++;
+    if (scrollOffset >= scrollLength + digitCount()) {
+        scrollOffset = 0;
+    }
+    renderScrollWindow();
+}
+
+void DisplayController::renderScrollWindow() {
+    // Window digit i shows message character (scrollOffset + i - width)
+    uint8_t width = digitCount();
+    for (uint8_t i = 0; i < width; i++) {
+        int16_t index = (int16_t)scrollOffset + i - width;
+        uint8_t segments = (index >= 0 && index < scrollLength) ? scrollSegments[index] : 0x00;
+        writeDigit(i, segments);
+    }
+}
+
+void DisplayController::flush() {
+    while (!isIdle()) {
+        update();
+        delayMicroseconds(DISPLAY_FLUSH_STEP_US);
+    }
+}
+
+bool DisplayController::isIdle() {
+    if (!bus.isIdle()) {
+        return false;
+    }
+    for (uint8_t module = 0; module < moduleCount; module++) {
+        if (dirtyDigits[module] != 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void DisplayController::begin() {
-    display.setBrightness(displayBrightness);
-    display.clear();
-    showStartupPattern();
+void DisplayController::writeDigit(uint8_t digit, uint8_t segments) {
+    uint8_t module = digit / TM1637_DIGITS;
+    uint8_t pos = digit % TM1637_DIGITS;
+    if (framebuffer[module][pos] != segments) {
+        framebuffer[module][pos] = segments;
+        dirtyDigits[module] |= (1 << pos);
+        segmentBytesChanged++;
+    }
+}
+
+void DisplayController::writeSegments(uint8_t first, const uint8_t segments[TM1637_DIGITS]) {
+    for (uint8_t i = 0; i < TM1637_DIGITS; i++) {
+        writeDigit(first + i, segments[i]);
+    }
+}
+
+void DisplayController::markControlDirty() {
+    // Any write carries the control byte
+    for (uint8_t module = 0; module < moduleCount; module++) {
+        dirtyDigits[module] |= 0x01;
+    }
+}
+
+uint8_t DisplayController::controlByte() {
+    uint8_t control = TM1637_CMD_CONTROL | (displayBrightness & 0x07);
+    if (displayEnabled) {
+        control |= TM1637_CONTROL_ON;
+    }
+    return control;
 }
 
 void DisplayController::showStartupPattern() {
-    display.showNumberDec(8888); // All segments on briefly
+    // All segments on briefly (blocking - runs once from begin())
+    for (uint8_t digit = 0; digit < digitCount(); digit++) {
+        writeDigit(digit, 0x7F); // "8888"
+    }
+    flush();
     delay(500);
-    display.clear();
+    clear();
+    flush();
 }
 
 void DisplayController::showReady() {
-    uint8_t readySegments[] = {0x50, 0x79, 0x5E, 0x6E}; // "REDY"
-    display.setSegments(readySegments);
+    stopScroll();
+    static const uint8_t readySegments[TM1637_DIGITS] = {0x50, 0x79, 0x5E, 0x6E}; // "REDY"
+    writeSegments(0, readySegments);
 }
 
 void DisplayController::showDashes() {
-    uint8_t dashSegments[] = {0x40, 0x40, 0x40, 0x40}; // "----"
-    display.setSegments(dashSegments);
+    stopScroll();
+    for (uint8_t digit = 0; digit < digitCount(); digit++) {
+        writeDigit(digit, 0x40); // "----"
+    }
 }
 
 void DisplayController::setDebugMode(bool debug) {
     debugMode = debug;
 }
 
-bool DisplayController::processCommand(String command) {
-    // Convert to uppercase for display commands
-    command.toUpperCase();
+bool DisplayController::processCommand(char* args) {
+    // Display commands are case-insensitive
+    upcaseInPlace(args);
 
-    if (!command.startsWith("DISP:")) {
-        return false; // Not a display command
+    // DISP:SCROLL:text[:ms] - the part after the last ':' is the interval
+    // only if it is 1-4 digits with text left in front of it, so
+    // DISP:SCROLL:10:30 is "10" at 30ms and "12:30" needs DISP:SCROLL:12:30:150
+    if (strncmp_P(args, PSTR("SCROLL:"), 7) == 0) {
+        if (!BuildProfile::displayEffects) return false;
+        char* text = args + 7;
+        uint16_t interval = DISPLAY_SCROLL_DEFAULT_MS;
+        char* colon = strrchr(text, ':');
+        if (colon != nullptr && colon != text && isNumericString(colon + 1) &&
+            strlen(colon + 1) <= 4) {
+            interval = atoi(colon + 1);
+            *colon = '\0';
+        }
+        if (*text == '\0') return false;
+        scrollText(text, interval);
+        if (BuildProfile::debug(debugMode)) {
+            Serial.print(F("Scrolling: "));
+            Serial.println(text);
+        }
+        return true;
     }
 
-    String param = command.substring(5);
+    // Optional module address: DISP:<n>:text / DISP:<n>:CLR, n = 1..moduleCount.
+    // Only with chained modules - on a single display DISP:1:30 stays the
+    // text "1:30", as it always was.
+    int8_t module = -1;
+    if (moduleCount > 1 && args[0] >= '1' && args[0] < '1' + moduleCount && args[1] == ':') {
+        module = args[0] - '1';
+        args += 2;
+    }
 
-    if (param == "CLR") {
-        clear();
-        if (debugMode) Serial.println(F("Display cleared"));
+    if (strcmp_P(args, PSTR("CLR")) == 0) {
+        if (module < 0) {
+            clear();
+        } else {
+            clearModule(module);
+        }
+        if (BuildProfile::debug(debugMode)) Serial.println(F("Display cleared"));
 
-    } else if (param == "ON") {
+    } else if (strcmp_P(args, PSTR("ON")) == 0) {
         turnOn();
-        if (debugMode) Serial.println(F("Display turned ON"));
+        if (BuildProfile::debug(debugMode)) Serial.println(F("Display turned ON"));
 
-    } else if (param == "OFF") {
+    } else if (strcmp_P(args, PSTR("OFF")) == 0) {
         turnOff();
-        if (debugMode) Serial.println(F("Display turned OFF"));
+        if (BuildProfile::debug(debugMode)) Serial.println(F("Display turned OFF"));
 
-    } else if (param.startsWith("BRT:")) {
-        int brightness = param.substring(4).toInt();
+    } else if (strncmp_P(args, PSTR("BRT:"), 4) == 0) {
+        int brightness = atoi(args + 4);
         if (brightness >= 0 && brightness <= 7) {
             setBrightness(brightness);
-            if (debugMode) {
+            if (BuildProfile::debug(debugMode)) {
                 Serial.print(F("Display brightness set to: "));
                 Serial.println(brightness);
             }
-        } else if (debugMode) {
+        } else if (BuildProfile::debug(debugMode)) {
             Serial.println(F("Invalid brightness (0-7)"));
         }
 
     } else {
         // Display text or number
         if (displayEnabled) {
-            displayText(param);
-            if (debugMode) {
+            if (module < 0) {
+                displayText(args);
+            } else {
+                displayText(module, args);
+            }
+            if (BuildProfile::debug(debugMode)) {
                 Serial.print(F("Displayed: "));
-                Serial.println(param);
+                Serial.println(args);
             }
-        } else if (debugMode) {
+        } else if (BuildProfile::debug(debugMode)) {
             Serial.println(F("Display is OFF - use DISP:ON to enable"));
         }
     }
@@ -85,82 +280,114 @@ bool DisplayController::processCommand(String command) {
 }
 
 void DisplayController::clear() {
-    display.clear();
+    stopScroll();
+    for (uint8_t digit = 0; digit < digitCount(); digit++) {
+        writeDigit(digit, 0);
+    }
+}
+
+void DisplayController::clearModule(uint8_t module) {
+    if (module >= moduleCount) return;
+    stopScroll();
+    static const uint8_t blank[TM1637_DIGITS] = {0, 0, 0, 0};
+    writeSegments(module * TM1637_DIGITS, blank);
 }
 
-void DisplayController::displayText(String text) {
+void DisplayController::displayText(const char* text) {
     if (!displayEnabled) return;
+    stopScroll();
+    renderText(text, 0, digitCount());
+}
+
+void DisplayController::displayText(uint8_t module, const char* text) {
+    if (!displayEnabled || module >= moduleCount) return;
+    stopScroll();
+    renderText(text, module * TM1637_DIGITS, TM1637_DIGITS);
+}
+
+void DisplayController::renderText(const char* text, uint8_t first, uint8_t width) {
+    uint8_t length = strlen(text);
 
     // Check if it's a numeric string (including those with leading zeros)
-    if (isNumericString(text) && text.length() <= 4) {
-        displayNumericString(text);
+    if (isNumericString(text) && length <= width) {
+        displayNumericString(text, length, first, width);
     } else {
-        // Display as text (up to 4 characters)
-        if (text.length() > 4) {
-            text = text.substring(0, 4);
+        // Left-aligned, truncated to the available digits, rest blanked
+        for (uint8_t i = 0; i < width; i++) {
+            writeDigit(first + i, (i < length) ? encodeChar(text[i]) : 0x00);
         }
-
-        // Convert string to display segments
-        uint8_t segments[4] = {0, 0, 0, 0};
-        for (int i = 0; i < text.length() && i < 4; i++) {
-            segments[i] = encodeChar(text.charAt(i));
-        }
-        display.setSegments(segments);
     }
 }
 
 void DisplayController::displayNumber(int number) {
     if (!displayEnabled) return;
-    display.showNumberDec(number);
+    stopScroll();
+
+    // Right-aligned without leading zeros; keep the low characters that fit
+    char digits[7];
+    itoa(number, digits, 10);
+    uint8_t length = strlen(digits);
+    uint8_t width = digitCount();
+    const char* start = (length > width) ? digits + (length - width) : digits;
+    displayNumericString(start, strlen(start), 0, width);
+}
+
+void DisplayController::displaySegments(const uint8_t segments[TM1637_DIGITS]) {
+    displaySegments(0, segments);
+}
+
+void DisplayController::displaySegments(uint8_t module, const uint8_t segments[TM1637_DIGITS]) {
+    if (!displayEnabled || module >= moduleCount) return;
+    stopScroll();
+    writeSegments(module * TM1637_DIGITS, segments);
+}
+
+void DisplayController::displayDigit(uint8_t digit, uint8_t segments) {
+    if (!displayEnabled || digit >= digitCount()) return;
+    stopScroll();
+    writeDigit(digit, segments);
 }
 
 void DisplayController::setBrightness(int brightness) {
     if (brightness >= 0 && brightness <= 7) {
         displayBrightness = brightness;
-        if (displayEnabled) {
-            display.setBrightness(displayBrightness);
-        }
+        markControlDirty();
     }
 }
 
 void DisplayController::turnOn() {
     displayEnabled = true;
-    display.setBrightness(displayBrightness);
+    markControlDirty();
 }
 
 void DisplayController::turnOff() {
     displayEnabled = false;
-    display.setBrightness(0);
+    markControlDirty();
 }
 
 bool DisplayController::isEnabled() {
     return displayEnabled;
 }
 
-bool DisplayController::isNumericString(String str) {
-    if (str.length() == 0) return false;
-    for (int i = 0; i < str.length(); i++) {
-        if (!isdigit(str.charAt(i))) {
+bool DisplayController::isNumericString(const char* str) {
+    if (*str == '\0') return false;
+    for (; *str != '\0'; str++) {
+        if (!isdigit(*str)) {
             return false;
         }
     }
     return true;
 }
 
-void DisplayController::displayNumericString(String numStr) {
-    uint8_t segments[4] = {0, 0, 0, 0}; // All blank by default
-
+void DisplayController::displayNumericString(const char* numStr, uint8_t length,
+                                             uint8_t first, uint8_t width) {
     // Right-align the number (pad with blanks, not zeros)
-    int startPos = 4 - numStr.length();
-    if (startPos < 0) startPos = 0;
+    if (length > width) length = width;
+    uint8_t startPos = width - length;
 
-    // Leading positions remain blank (0x00)
-    // Fill only the actual digits from the string
-    for (int i = 0; i < numStr.length() && i < 4; i++) {
-        segments[startPos + i] = encodeChar(numStr.charAt(i));
+    for (uint8_t i = 0; i < width; i++) {
+        writeDigit(first + i, (i < startPos) ? 0x00 : encodeChar(numStr[i - startPos]));
     }
-
-    display.setSegments(segments);
 }
 
 uint8_t DisplayController::encodeChar(char c) {
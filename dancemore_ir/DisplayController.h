@@ -7,13 +7,33 @@
  * - On/off state management
  * - Serial command processing
  * - Character encoding for 7-segment display
+ * - Dirty-digit framebuffer flushed incrementally by update()
+ * - Up to DISPLAY_MAX_MODULES modules chained on a shared CLK line
+ *
+ * Digits are numbered across the whole group: module 0 holds digits 0-3,
+ * module 1 digits 4-7 and so on. Text and numbers span every module;
+ * DISP:<n>:text addresses a single module (1-based) when more than one
+ * is chained; with a single module it is plain text, as before.
+ *
+ * DISP:SCROLL:text:ms pre-encodes text once into a segment buffer and
+ * update() slides a window across it every ms milliseconds. A trailing
+ * :digits (up to 4) after non-empty text is always read as ms, so text
+ * that itself ends in :digits needs an explicit interval after it.
  */
 
 #ifndef DISPLAY_CONTROLLER_H
 #define DISPLAY_CONTROLLER_H
 
 #include <Arduino.h>
-#include <TM1637Display.h>
+#include "TM1637Bus.h"
+#include "CommandRegistry.h"
+
+#ifndef DISPLAY_MAX_MODULES
+#define DISPLAY_MAX_MODULES 8 // Framebuffer RAM: 5 bytes per module
+#endif
+
+#define DISPLAY_SCROLL_MAX 40            // Longest scrolling message (characters)
+#define DISPLAY_SCROLL_DEFAULT_MS 150    // Step interval when DISP:SCROLL omits :ms
 
 #define CHAR_LOOKUP_MIN 32  // ' '
 #define CHAR_LOOKUP_MAX 90  // 'Z'
@@ -43,35 +63,102 @@ static const uint8_t CHAR_LOOKUP[CHAR_LOOKUP_LEN] PROGMEM = {
 
 class DisplayController {
 private:
-    TM1637Display display;
+    TM1637Bus bus;
     uint8_t displayBrightness;
     bool displayEnabled;
     bool debugMode;
 
-    // Character encoding for 7-segment display
-    uint8_t encodeChar(char c);
+    // Module group - all modules share the bus CLK pin, one DIO pin each
+    uint8_t moduleDio[DISPLAY_MAX_MODULES];
+    uint8_t moduleCount;
+    uint8_t nextModule; // Round-robin start for the next dirty-module scan
+
+    // Segment framebuffers - update() sends only digits whose dirty bit is set
+    uint8_t framebuffer[DISPLAY_MAX_MODULES][TM1637_DIGITS];
+    uint8_t dirtyDigits[DISPLAY_MAX_MODULES]; // Bit n = digit n changed since last transmit
+    uint32_t segmentBytesChanged; // Framebuffer bytes rewritten (benchmark counter)
+
+    // Marquee state - text is encoded once, each step only moves the window
+    uint8_t scrollSegments[DISPLAY_SCROLL_MAX];
+    uint8_t scrollLength;   // 0 = not scrolling
+    uint8_t scrollOffset;   // Window position, 0..scrollLength + digitCount()
+    uint16_t scrollIntervalMillis;
+    unsigned long lastScrollStep;
+
+    void renderScrollWindow();
 
     // Check if a string contains only digits
-    bool isNumericString(String str);
+    bool isNumericString(const char* str);
+
+    // Right-align a numeric string within digits [first, first + width)
+    void displayNumericString(const char* numStr, uint8_t length, uint8_t first, uint8_t width);
+
+    // Left-aligned text (or right-aligned digits) within [first, first + width)
+    void renderText(const char* text, uint8_t first, uint8_t width);
 
-    // Display a numeric string exactly as specified (no automatic padding)
-    void displayNumericString(String numStr);
+    // Set one digit of the group, marking it dirty if it changed
+    void writeDigit(uint8_t digit, uint8_t segments);
+
+    // Copy one module's worth of segments starting at digit `first`
+    void writeSegments(uint8_t first, const uint8_t segments[TM1637_DIGITS]);
+
+    // Force a transmit on every module so they pick up a new control byte
+    void markControlDirty();
+
+    // Display control byte for the current brightness/on state
+    uint8_t controlByte();
 
 public:
     // Constructor
     DisplayController(int clkPin, int dioPin, bool debug = false);
 
-    // Initialize the display
-    void begin();
+    // Chain another module on the shared CLK pin - call before begin().
+    // Returns false when DISPLAY_MAX_MODULES modules are already attached.
+    bool addModule(uint8_t dioPin);
+
+    // Number of attached modules and total digits across them
+    uint8_t getModuleCount() { return moduleCount; }
+    uint8_t digitCount() { return moduleCount * TM1637_DIGITS; }
+
+    // Initialize the display; fast boot skips the 500ms startup pattern
+    void begin(bool startupPattern = true);
+
+    // Advance the non-blocking transmitter by one bus phase.
+    // Call from a scheduler task; each call toggles at most one pin.
+    void update();
+
+    // Block until the framebuffer has been fully transmitted (setup only)
+    void flush();
+
+    // True when nothing is waiting to be transmitted
+    bool isIdle();
+
+    // Character encoding for 7-segment display (0 for unsupported chars)
+    static uint8_t encodeChar(char c);
+
+    // Framebuffer bytes that actually changed since boot
+    uint32_t changedSegmentCount() { return segmentBytesChanged; }
 
-    // Process display commands from serial input
-    // Returns true if command was processed, false if not a display command
-    bool processCommand(String command);
+    // Process a display command (text after the "DISP:" prefix).
+    // Uppercases args in place. Returns true if the command was processed.
+    bool processCommand(char* args);
 
     // Direct display control methods
     void clear();
-    void displayText(String text);
+    void clearModule(uint8_t module);
+    void scrollText(const char* text, uint16_t intervalMillis); // Loops until replaced
+    void stopScroll();
+    bool isScrolling() { return scrollLength > 0; }
+
+    // Advance the marquee window if its interval has elapsed - driven from
+    // the animation tick so the 50us bus task never reads the clock
+    void updateScroll(unsigned long now);
+    void displayText(const char* text);                 // Spans every module
+    void displayText(uint8_t module, const char* text); // One module (0-based)
     void displayNumber(int number);
+    void displaySegments(const uint8_t segments[TM1637_DIGITS]); // Module 0
+    void displaySegments(uint8_t module, const uint8_t segments[TM1637_DIGITS]);
+    void displayDigit(uint8_t digit, uint8_t segments); // Digit index across all modules
     void setBrightness(int brightness);
     void turnOn();
     void turnOff();
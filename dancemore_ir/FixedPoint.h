@@ -0,0 +1,56 @@
+/*
+ * FixedPoint.h - 8-bit fixed-point color math for the LED effects
+ *
+ * The ATmega328 has a 2-cycle 8x8 hardware multiply but no divider or FPU,
+ * so every effect works in Q8: a fraction f/256 is applied as a multiply
+ * and a shift. Nothing here divides, calls a float routine or random().
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// value * scale / 255, exact at both ends: scale8(v, 255) == v, scale8(v, 0) == 0
+inline uint8_t scale8(uint8_t value, uint8_t scale) {
+  return ((uint16_t)value * (scale + 1)) >> 8;
+}
+
+// Blend from -> to by fraction/256
+inline uint8_t lerp8(uint8_t from, uint8_t to, uint8_t fraction) {
+  if (to >= from) {
+    return from + (uint8_t)(((uint16_t)(to - from) * fraction) >> 8);
+  }
+  return from - (uint8_t)(((uint16_t)(from - to) * fraction) >> 8);
+}
+
+// xorshift8 (7, 5, 3) - period 255, a handful of shifts per call
+inline uint8_t random8() {
+  static uint8_t state = 0x5A; // Any non-zero seed
+  state ^= state << 7;
+  state ^= state >> 5;
+  state ^= state << 3;
+  return state;
+}
+
+// Uniform-enough 0..limit-1 without a modulo
+inline uint8_t random8(uint8_t limit) {
+  return ((uint16_t)random8() * limit) >> 8;
+}
+
+// Sample a PROGMEM RGB palette of 2^sizeLog2 entries (sizeLog2 <= 8) at a
+// 16-bit position around the loop: the top sizeLog2 bits pick the entry,
+// the next 8 bits blend toward its neighbour (wrapping at the end)
+inline void paletteColor(const uint8_t (*palette)[3], uint8_t sizeLog2, uint16_t position,
+                         uint8_t& r, uint8_t& g, uint8_t& b) {
+  uint8_t shift = 16 - sizeLog2;
+  uint8_t entry = position >> shift;
+  uint8_t next = (entry + 1) & ((1 << sizeLog2) - 1);
+  uint8_t fraction = (uint8_t)(position >> (shift - 8));
+  r = lerp8(pgm_read_byte(&palette[entry][0]), pgm_read_byte(&palette[next][0]), fraction);
+  g = lerp8(pgm_read_byte(&palette[entry][1]), pgm_read_byte(&palette[next][1]), fraction);
+  b = lerp8(pgm_read_byte(&palette[entry][2]), pgm_read_byte(&palette[next][2]), fraction);
+}
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * FlipperExport.cpp - Flipper .ir record rendering
+ */
+
+#include "FlipperExport.h"
+
+// Template fields, replaced during expansion
+#define FIELD_NAME     '\x01'
+#define FIELD_PROTOCOL '\x02'
+#define FIELD_ADDRESS  '\x03'
+#define FIELD_COMMAND  '\x04'
+
+static const char FILE_HEADER[] PROGMEM = "Filetype: IR signals file\r\nVersion: 1\r\n";
+static const char RECORD_TEMPLATE[] PROGMEM =
+  "name: btn_\x01\r\n"
+  "type: parsed\r\n"
+  "protocol: \x02\r\n"
+  "address: \x03\r\n"
+  "command: \x04\r\n"
+  "#\r\n";
+
+static const char HEX_DIGITS[] PROGMEM = "0123456789ABCDEF";
+
+// Write (or just count) one character of an expanded record
+static inline void emit(TxRing& ring, bool write, uint8_t& length, char c) {
+  if (write) {
+    ring.put(c);
+  }
+  length++;
+}
+
+// Flipper stores address and command as 4 little-endian bytes: "04 00 00 00"
+static void emitBytes(TxRing& ring, bool write, uint8_t& length, uint16_t value) {
+  for (uint8_t i = 0; i < 4; i++) {
+    uint8_t byte = (i < 2) ? (uint8_t)(value >> (i * 8)) : 0;
+    if (i > 0) {
+      emit(ring, write, length, ' ');
+    }
+    emit(ring, write, length, (char)pgm_read_byte(&HEX_DIGITS[byte >> 4]));
+    emit(ring, write, length, (char)pgm_read_byte(&HEX_DIGITS[byte & 0x0F]));
+  }
+}
+
+static void emitDecimal(TxRing& ring, bool write, uint8_t& length, uint16_t value) {
+  char digits[5];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  while (n > 0) {
+    emit(ring, write, length, digits[--n]);
+  }
+}
+
+FlipperExport::FlipperExport(TxRing& ring, const CaptureHistory& history,
+                             ProtocolNameFunction protocolName)
+  : ring(ring), history(history), protocolName(protocolName), live(false),
+    headerPending(false), dumping(false), dumpSequence(0), dumpEnd(0), recordNumber(0) {
+}
+
+uint8_t FlipperExport::expandRecord(bool write, uint8_t protocol, uint16_t address, uint16_t command) {
+  uint8_t length = 0;
+  const char* p = RECORD_TEMPLATE;
+  char c;
+  while ((c = pgm_read_byte(p++)) != '\0') {
+    switch (c) {
+      case FIELD_NAME:
+        emitDecimal(ring, write, length, recordNumber + 1);
+        break;
+      case FIELD_PROTOCOL: {
+        const char* name = (const char*)protocolName(protocol);
+        char n;
+        while ((n = pgm_read_byte(name++)) != '\0') {
+          emit(ring, write, length, n);
+        }
+        break;
+      }
+      case FIELD_ADDRESS:
+        emitBytes(ring, write, length, address);
+        break;
+      case FIELD_COMMAND:
+        emitBytes(ring, write, length, command);
+        break;
+      default:
+        emit(ring, write, length, c);
+        break;
+    }
+  }
+  return length;
+}
+
+bool FlipperExport::queueHeader() {
+  if (!headerPending) {
+    return true;
+  }
+  uint8_t length = strlen_P(FILE_HEADER);
+  if (length > ring.freeSpace()) {
+    return false;
+  }
+  for (uint8_t i = 0; i < length; i++) {
+    ring.put((char)pgm_read_byte(&FILE_HEADER[i]));
+  }
+  headerPending = false;
+  return true;
+}
+
+bool FlipperExport::exportCapture(uint8_t protocol, uint16_t address, uint16_t command) {
+  if (!queueHeader()) {
+    ring.countDrop();
+    return false;
+  }
+  if (!ring.reserve(expandRecord(false, protocol, address, command))) {
+    return false;
+  }
+  expandRecord(true, protocol, address, command);
+  recordNumber++;
+  return true;
+}
+
+// A button already replayed earlier in this dump
+bool FlipperExport::isDuplicate(uint16_t sequence, const CaptureRecord& record) const {
+  CaptureRecord earlier;
+  for (uint16_t s = history.firstSequence(); s != sequence; s++) {
+    if (history.get(s, earlier) && earlier.protocol == record.protocol &&
+        earlier.address == record.address && earlier.command == record.command) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FlipperExport::pump() {
+  if (!queueHeader() || !dumping) {
+    return;
+  }
+
+  while (dumpSequence != dumpEnd) {
+    CaptureRecord record;
+    if (!history.get(dumpSequence, record)) {
+      // Overwritten by new captures since the dump started - catch up
+      if ((int16_t)(dumpSequence - history.firstSequence()) < 0 &&
+          (int16_t)(dumpEnd - history.firstSequence()) > 0) {
+        dumpSequence = history.firstSequence();
+        continue;
+      }
+      break;
+    }
+
+    if (!isDuplicate(dumpSequence, record)) {
+      uint8_t length = expandRecord(false, record.protocol, record.address, record.command);
+      if (length > ring.freeSpace()) {
+        return; // Wait for the UART to drain
+      }
+      expandRecord(true, record.protocol, record.address, record.command);
+      recordNumber++;
+    }
+    dumpSequence++;
+  }
+  dumping = false;
+}
+
+// EXPORT:ON / EXPORT:OFF toggle live records, EXPORT:DUMP replays the history.
+// A dump and the live stream would share one file on the host - a second
+// header mid-stream and btn_<n> restarting at 1 - so each refuses to start
+// while the other is running.
+bool FlipperExport::processCommand(char* args) {
+  if (strcasecmp_P(args, PSTR("ON")) == 0) {
+    if (dumping) return false;
+    live = true;
+    headerPending = true;
+    recordNumber = 0;
+  } else if (strcasecmp_P(args, PSTR("OFF")) == 0) {
+    live = false;
+  } else if (strcasecmp_P(args, PSTR("DUMP")) == 0) {
+    if (live) return false;
+    dumping = true;
+    headerPending = true;
+    dumpSequence = history.firstSequence();
+    dumpEnd = history.endSequence();
+    recordNumber = 0;
+  } else {
+    return false;
+  }
+  return true;
+}
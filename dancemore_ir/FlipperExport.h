@@ -0,0 +1,62 @@
+/*
+ * FlipperExport.h - Flipper Zero .ir file records over serial
+ *
+ * EXPORT:ON replaces the one-line Flipper output with complete .ir
+ * records (name, type, protocol, address and command as little-endian
+ * byte strings), so a host can save the serial stream as a file as-is.
+ * EXPORT:DUMP replays the capture history the same way, one record per
+ * distinct button. Each is its own file, so DUMP is refused while live
+ * mode is on, and ON while a dump is running.
+ *
+ * Records are expanded from a PROGMEM template straight into the TX ring -
+ * no intermediate line buffer - and a dump queues as many records per
+ * tick as the ring has room for, so it drains at the UART line rate.
+ */
+
+#ifndef FLIPPER_EXPORT_H
+#define FLIPPER_EXPORT_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "SerialOutput.h"
+#include "CaptureHistory.h"
+
+// Protocol names come from IRremote, which only the sketch may include
+typedef const __FlashStringHelper* (*ProtocolNameFunction)(uint8_t protocol);
+
+class FlipperExport {
+private:
+  TxRing& ring;
+  const CaptureHistory& history;
+  ProtocolNameFunction protocolName;
+
+  bool live;            // EXPORT:ON - every new capture becomes a record
+  bool headerPending;   // File header still to be queued
+  bool dumping;         // EXPORT:DUMP in progress
+  uint16_t dumpSequence; // Next history record to replay
+  uint16_t dumpEnd;      // History end when the dump started
+  uint16_t recordNumber; // Last record name used (btn_<n>)
+
+  // Expand the record template; write = false only measures it
+  uint8_t expandRecord(bool write, uint8_t protocol, uint16_t address, uint16_t command);
+  bool queueHeader();
+  bool isDuplicate(uint16_t sequence, const CaptureRecord& record) const;
+
+public:
+  FlipperExport(TxRing& ring, const CaptureHistory& history, ProtocolNameFunction protocolName);
+
+  bool isLive() const { return live; }
+  bool isBusy() const { return dumping || headerPending; }
+
+  // Live mode: queue one record for a new capture. False (and a counted
+  // TX drop) when the ring has no room.
+  bool exportCapture(uint8_t protocol, uint16_t address, uint16_t command);
+
+  // Scheduler hook: continue a dump, waiting for ring space between records
+  void pump();
+
+  // Command processing (text after the "EXPORT:" prefix)
+  bool processCommand(char* args);
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * HoldTracker.cpp - Repeat-frame coalescing implementation
+ */
+
+#include "HoldTracker.h"
+
+HoldTracker::HoldTracker()
+  : active(false), protocol(0), address(0), command(0), startMicros(0), lastMicros(0),
+    lastReportMicros(0), frames(0), debounceMillis(HOLD_DEBOUNCE_DEFAULT_MS),
+    reportMillis(HOLD_REPORT_DEFAULT_MS), reportsEnabled(false) {
+}
+
+bool HoldTracker::matches(uint8_t protocol, uint16_t address, uint16_t command) const {
+  return protocol == this->protocol && address == this->address && command == this->command;
+}
+
+bool HoldTracker::hasExpired(unsigned long nowMicros) const {
+  return active && (nowMicros - lastMicros) > debounceMillis * 1000UL;
+}
+
+bool HoldTracker::endsHold(uint8_t protocol, uint16_t address, uint16_t command,
+                           unsigned long nowMicros) const {
+  return active && (!matches(protocol, address, command) || hasExpired(nowMicros));
+}
+
+HoldEvent HoldTracker::track(uint8_t protocol, uint16_t address, uint16_t command, bool isRepeat,
+                             unsigned long nowMicros) {
+  if (active && matches(protocol, address, command) && !hasExpired(nowMicros)) {
+    lastMicros = nowMicros;
+    if (frames < 0xFFFF) {
+      frames++;
+    }
+    if ((nowMicros - lastReportMicros) >= reportMillis * 1000UL) {
+      lastReportMicros = nowMicros;
+      return HOLD_SUMMARY;
+    }
+    return HOLD_REPEAT;
+  }
+
+  if (isRepeat) {
+    return HOLD_IGNORED;
+  }
+
+  active = true;
+  this->protocol = protocol;
+  this->address = address;
+  this->command = command;
+  startMicros = nowMicros;
+  lastMicros = nowMicros;
+  lastReportMicros = nowMicros;
+  frames = 1;
+  return HOLD_PRESS;
+}
+
+// HOLD:ON / HOLD:OFF, HOLD:DEBOUNCE:<ms>, HOLD:REPORT:<ms>
+bool HoldTracker::processCommand(char* args) {
+  if (strcasecmp_P(args, PSTR("ON")) == 0) {
+    reportsEnabled = true;
+  } else if (strcasecmp_P(args, PSTR("OFF")) == 0) {
+    reportsEnabled = false;
+  } else if (strncasecmp_P(args, PSTR("DEBOUNCE:"), 9) == 0) {
+    int value = atoi(args + 9);
+    if (value <= 0) {
+      return false;
+    }
+    debounceMillis = value;
+  } else if (strncasecmp_P(args, PSTR("REPORT:"), 7) == 0) {
+    int value = atoi(args + 7);
+    if (value <= 0) {
+      return false;
+    }
+    reportMillis = value;
+  } else {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,76 @@
+/*
+ * HoldTracker.h - Repeat-frame coalescing for held remote buttons
+ *
+ * A held button arrives as a press followed by a repeat frame every
+ * ~45-110ms (NEC repeat codes, or the full frame resent for Sony/RC5).
+ * The tracker folds that stream into one press, a periodic "held" summary
+ * and a release once no frame for the key has arrived for the debounce
+ * window, so the host gets hold semantics without a line per repeat.
+ *
+ * Frames of the active key inside the debounce window count as part of
+ * the hold even without the repeat flag - that is the debounce for
+ * protocols that resend whole frames.
+ */
+
+#ifndef HOLD_TRACKER_H
+#define HOLD_TRACKER_H
+
+#include <Arduino.h>
+
+#define HOLD_DEBOUNCE_DEFAULT_MS 150 // Longer than the slowest repeat spacing (~114ms RC5)
+#define HOLD_REPORT_DEFAULT_MS 1000
+
+enum HoldEvent {
+  HOLD_IGNORED, // Stray repeat with no press to attach it to
+  HOLD_PRESS,   // New press - the normal event line
+  HOLD_REPEAT,  // Folded into the running hold, nothing to print
+  HOLD_SUMMARY  // Folded in, and a periodic summary is due
+};
+
+class HoldTracker {
+private:
+  bool active;
+  uint8_t protocol;
+  uint16_t address;
+  uint16_t command;
+  unsigned long startMicros;
+  unsigned long lastMicros;
+  unsigned long lastReportMicros;
+  uint16_t frames;         // Frames in this hold, including the press
+
+  uint16_t debounceMillis;
+  uint16_t reportMillis;
+  bool reportsEnabled;     // HOLD:ON - summary/release lines in normal output
+
+  bool matches(uint8_t protocol, uint16_t address, uint16_t command) const;
+
+public:
+  HoldTracker();
+
+  // True when the running hold must be released before this frame is
+  // tracked (different key, or the debounce window has passed)
+  bool endsHold(uint8_t protocol, uint16_t address, uint16_t command, unsigned long nowMicros) const;
+
+  // True when the running hold has timed out without another frame
+  bool hasExpired(unsigned long nowMicros) const;
+
+  // Classify a decoded, non-noise frame
+  HoldEvent track(uint8_t protocol, uint16_t address, uint16_t command, bool isRepeat,
+                  unsigned long nowMicros);
+
+  // Forget the hold once its release has been reported
+  void release() { active = false; }
+
+  bool isActive() const { return active; }
+  bool reportsOn() const { return reportsEnabled; }
+  uint8_t heldProtocol() const { return protocol; }
+  uint16_t heldAddress() const { return address; }
+  uint16_t heldCommand() const { return command; }
+  uint16_t heldFrames() const { return frames; }
+  unsigned long heldMillis() const { return (lastMicros - startMicros) / 1000UL; }
+
+  // Command processing (text after the "HOLD:" prefix)
+  bool processCommand(char* args);
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * IREventQueue.cpp - Fixed-size SPSC IR event queue implementation
+ */
+
+#include "IREventQueue.h"
+
+IREventQueue::IREventQueue() : head(0), tail(0), overflows(0) {
+}
+
+bool IREventQueue::push(const IREvent& event) {
+  uint8_t next = (head + 1) & (IR_EVENT_QUEUE_SIZE - 1);
+  if (next == tail) {
+    overflows++;
+    return false;
+  }
+
+  events[head] = event;
+  head = next; // Publish only after the slot is written
+  return true;
+}
+
+bool IREventQueue::pop(IREvent& event) {
+  if (head == tail) {
+    return false;
+  }
+
+  event = events[tail];
+  tail = (tail + 1) & (IR_EVENT_QUEUE_SIZE - 1);
+  return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * IREventQueue.h - Fixed-size SPSC queue of decoded IR frames
+ *
+ * The IR poll task pushes an event straight after IrReceiver.decode() and
+ * resumes the receiver immediately; a separate consumer task pops events
+ * and does the slow filtering and printing. A press that arrives while the
+ * consumer is busy is captured instead of lost.
+ *
+ * Single producer / single consumer: head is only written by push(), tail
+ * only by pop(), so no locking is needed even if the producer moves to an
+ * interrupt later.
+ */
+
+#ifndef IR_EVENT_QUEUE_H
+#define IR_EVENT_QUEUE_H
+
+#include <Arduino.h>
+
+#define IR_EVENT_QUEUE_SIZE 8 // Power of 2 - indices wrap with a mask
+
+struct IREvent {
+  uint8_t protocol;        // IRremote decode_type_t
+  uint8_t flags;           // IRremote IRDATA_FLAGS_* as decoded
+  uint8_t bits;
+  uint16_t address;
+  uint16_t command;
+  uint32_t rawData;
+  unsigned long timestamp; // micros() at capture
+};
+
+class IREventQueue {
+private:
+  IREvent events[IR_EVENT_QUEUE_SIZE];
+  volatile uint8_t head; // Next slot to fill
+  volatile uint8_t tail; // Next slot to drain
+  uint16_t overflows;
+
+public:
+  // Constructor
+  IREventQueue();
+
+  // Producer side - returns false (and counts it) when full
+  bool push(const IREvent& event);
+
+  // Consumer side - returns false when empty
+  bool pop(IREvent& event);
+
+  bool isEmpty() const { return head == tail; }
+  uint16_t overflowCount() const { return overflows; }
+};
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * IRMacros.cpp - Learned IR button -> local action table implementation
+ */
+
+#include "IRMacros.h"
+#include <EEPROM.h>
+#include "PersistentConfig.h"
+
+// EEPROM record: marker | protocol | address LE | command LE | action text
+#define MACRO_RECORD_MARKER 0xA7
+#define MACRO_RECORD_HEADER 6
+#define MACRO_RECORD_SIZE (MACRO_RECORD_HEADER + MACRO_ACTION_MAX)
+
+static_assert(CONFIG_EEPROM_ADDRESS + 3 + sizeof(DeviceConfig) + 1 <= MACRO_EEPROM_ADDRESS,
+              "Macro table overlaps the config block");
+static_assert((MACRO_HASH_SLOTS & (MACRO_HASH_SLOTS - 1)) == 0 && MACRO_HASH_SLOTS >= MAX_MACROS,
+              "MACRO_HASH_SLOTS must be a power of two >= MAX_MACROS");
+
+MacroKey IRMacros::keys[MAX_MACROS];
+bool IRMacros::used[MAX_MACROS];
+uint8_t IRMacros::slots[MACRO_HASH_SLOTS];
+IRMacros::LearnState IRMacros::learnState = IRMacros::LEARN_IDLE;
+char IRMacros::pendingAction[MACRO_ACTION_MAX];
+
+uint8_t IRMacros::hashKey(uint8_t protocol, uint16_t address, uint16_t command) {
+  // Buttons on one remote differ in command, remotes differ in address
+  uint16_t h = command * 31 + address * 7 + protocol;
+  return (uint8_t)(h ^ (h >> 8)) & (MACRO_HASH_SLOTS - 1);
+}
+
+int IRMacros::recordAddress(uint8_t index) {
+  return MACRO_EEPROM_ADDRESS + index * MACRO_RECORD_SIZE;
+}
+
+void IRMacros::rebuildIndex() {
+  memset(slots, MACRO_NONE, sizeof(slots));
+  for (uint8_t i = 0; i < MAX_MACROS; i++) {
+    if (!used[i]) continue;
+    uint8_t slot = hashKey(keys[i].protocol, keys[i].address, keys[i].command);
+    while (slots[slot] != MACRO_NONE) {
+      slot = (slot + 1) & (MACRO_HASH_SLOTS - 1);
+    }
+    slots[slot] = i;
+  }
+}
+
+void IRMacros::begin() {
+  for (uint8_t i = 0; i < MAX_MACROS; i++) {
+    int address = recordAddress(i);
+    used[i] = (EEPROM.read(address) == MACRO_RECORD_MARKER);
+    if (used[i]) {
+      keys[i].protocol = EEPROM.read(address + 1);
+      keys[i].address = EEPROM.read(address + 2) | (EEPROM.read(address + 3) << 8);
+      keys[i].command = EEPROM.read(address + 4) | (EEPROM.read(address + 5) << 8);
+    }
+  }
+  rebuildIndex();
+}
+
+uint8_t IRMacros::find(uint8_t protocol, uint16_t address, uint16_t command) {
+  uint8_t slot = hashKey(protocol, address, command);
+
+  // Linear probe until a hit or an empty slot (table is never full)
+  for (uint8_t probes = 0; probes < MACRO_HASH_SLOTS; probes++) {
+    uint8_t index = slots[slot];
+    if (index == MACRO_NONE) {
+      return MACRO_NONE;
+    }
+    const MacroKey& key = keys[index];
+    if (key.command == command && key.address == address && key.protocol == protocol) {
+      return index;
+    }
+    slot = (slot + 1) & (MACRO_HASH_SLOTS - 1);
+  }
+  return MACRO_NONE;
+}
+
+void IRMacros::readAction(uint8_t index, char* buffer) {
+  int address = recordAddress(index) + MACRO_RECORD_HEADER;
+  for (uint8_t i = 0; i < MACRO_ACTION_MAX; i++) {
+    buffer[i] = EEPROM.read(address + i);
+  }
+  buffer[MACRO_ACTION_MAX - 1] = '\0';
+}
+
+void IRMacros::writeEntry(uint8_t index, const MacroKey& key, const char* action) {
+  int address = recordAddress(index);
+  EEPROM.update(address + 1, key.protocol);
+  EEPROM.update(address + 2, key.address & 0xFF);
+  EEPROM.update(address + 3, key.address >> 8);
+  EEPROM.update(address + 4, key.command & 0xFF);
+  EEPROM.update(address + 5, key.command >> 8);
+  uint8_t length = strlen(action);
+  for (uint8_t i = 0; i < MACRO_ACTION_MAX; i++) {
+    EEPROM.update(address + MACRO_RECORD_HEADER + i, (i < length) ? action[i] : '\0');
+  }
+  EEPROM.update(address, MACRO_RECORD_MARKER); // Marker last: a torn write stays invalid
+
+  keys[index] = key;
+  used[index] = true;
+}
+
+void IRMacros::eraseEntry(uint8_t index) {
+  EEPROM.update(recordAddress(index), 0xFF);
+  used[index] = false;
+}
+
+bool IRMacros::capture(uint8_t protocol, uint16_t address, uint16_t command) {
+  if (learnState == LEARN_IDLE) {
+    return false;
+  }
+
+  uint8_t index = find(protocol, address, command);
+
+  if (learnState == LEARN_FORGET) {
+    learnState = LEARN_IDLE;
+    if (index == MACRO_NONE) {
+      Serial.println(F("LEARN not bound"));
+      return true;
+    }
+    eraseEntry(index);
+    rebuildIndex();
+    Serial.print(F("LEARN forgot "));
+    Serial.println(index);
+    return true;
+  }
+
+  // Rebinding a known button reuses its entry, otherwise take a free one
+  if (index == MACRO_NONE) {
+    for (uint8_t i = 0; i < MAX_MACROS; i++) {
+      if (!used[i]) {
+        index = i;
+        break;
+      }
+    }
+  }
+  learnState = LEARN_IDLE;
+  if (index == MACRO_NONE) {
+    Serial.println(F("LEARN table full"));
+    return true;
+  }
+
+  MacroKey key = {protocol, address, command};
+  writeEntry(index, key, pendingAction);
+  rebuildIndex();
+  Serial.print(F("LEARN bound "));
+  Serial.print(index);
+  Serial.print(' ');
+  Serial.println(pendingAction);
+  return true;
+}
+
+// LEARN:<action>   bind the next button to a command line
+// LEARN:FORGET     unbind the next button
+// LEARN:LIST       print the table
+// LEARN:CLEAR      erase every entry
+// LEARN:CANCEL     disarm
+bool IRMacros::processCommand(char* args) {
+  if (strcasecmp_P(args, PSTR("LIST")) == 0) {
+    printTable();
+  } else if (strcasecmp_P(args, PSTR("CLEAR")) == 0) {
+    for (uint8_t i = 0; i < MAX_MACROS; i++) {
+      if (used[i]) eraseEntry(i);
+    }
+    rebuildIndex();
+    Serial.println(F("LEARN cleared"));
+  } else if (strcasecmp_P(args, PSTR("CANCEL")) == 0) {
+    learnState = LEARN_IDLE;
+  } else if (strcasecmp_P(args, PSTR("FORGET")) == 0) {
+    learnState = LEARN_FORGET;
+    Serial.println(F("LEARN press a button to forget"));
+  } else {
+    // Macros can't re-arm learning from a button press
+    uint8_t length = strlen(args);
+    if (length == 0 || length >= MACRO_ACTION_MAX || strncasecmp_P(args, PSTR("LEARN:"), 6) == 0) {
+      return false;
+    }
+    memcpy(pendingAction, args, length + 1);
+    learnState = LEARN_BIND;
+    Serial.println(F("LEARN press a button"));
+  }
+  return true;
+}
+
+void IRMacros::printTable() {
+  char action[MACRO_ACTION_MAX];
+  for (uint8_t i = 0; i < MAX_MACROS; i++) {
+    if (!used[i]) continue;
+    readAction(i, action);
+    Serial.print(F("LEARN "));
+    Serial.print(i);
+    Serial.print(F(" p="));
+    Serial.print(keys[i].protocol);
+    Serial.print(F(" a=0x"));
+    Serial.print(keys[i].address, HEX);
+    Serial.print(F(" c=0x"));
+    Serial.print(keys[i].command, HEX);
+    Serial.print(' ');
+    Serial.println(action);
+  }
+}
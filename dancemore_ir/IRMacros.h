@@ -0,0 +1,73 @@
+/*
+ * IRMacros.h - Learned IR button -> local action table
+ *
+ * Maps {protocol, address, command} to a command line ("LED:fire 5",
+ * "DISP:HELO", "SCENE:busy 10") that the sketch dispatches the moment the
+ * button is decoded, without a round trip through the host.
+ *
+ * Keys live in RAM behind a small open-addressing hash (linear probing,
+ * MACRO_HASH_SLOTS slots for MAX_MACROS entries), so each decoded frame
+ * costs one hash and typically one probe. Action text stays in EEPROM and
+ * is only read when a key matches.
+ *
+ * LEARN:<action> binds the next button pressed; LEARN:FORGET unbinds it.
+ */
+
+#ifndef IR_MACROS_H
+#define IR_MACROS_H
+
+#include <Arduino.h>
+
+#define MAX_MACROS 12
+#define MACRO_HASH_SLOTS 16      // Power of two, >= MAX_MACROS
+#define MACRO_ACTION_MAX 24      // Action text including terminator
+#define MACRO_EEPROM_ADDRESS 32  // After the PersistentConfig block
+#define MACRO_NONE 0xFF
+
+struct MacroKey {
+  uint8_t protocol;
+  uint16_t address;
+  uint16_t command;
+};
+
+class IRMacros {
+private:
+  enum LearnState : uint8_t { LEARN_IDLE, LEARN_BIND, LEARN_FORGET };
+
+  static MacroKey keys[MAX_MACROS];
+  static bool used[MAX_MACROS];
+  static uint8_t slots[MACRO_HASH_SLOTS]; // Entry index or MACRO_NONE
+
+  // Armed by LEARN:, consumed by the next captured button
+  static LearnState learnState;
+  static char pendingAction[MACRO_ACTION_MAX];
+
+  static uint8_t hashKey(uint8_t protocol, uint16_t address, uint16_t command);
+  static void rebuildIndex();
+  static int recordAddress(uint8_t index);
+  static void writeEntry(uint8_t index, const MacroKey& key, const char* action);
+  static void eraseEntry(uint8_t index);
+
+public:
+  // Load stored entries from EEPROM and build the hash index
+  static void begin();
+
+  // Entry index for a key, or MACRO_NONE
+  static uint8_t find(uint8_t protocol, uint16_t address, uint16_t command);
+
+  // Copy an entry's action text out of EEPROM
+  static void readAction(uint8_t index, char* buffer);
+
+  // Offer a decoded (non-repeat) button to an armed LEARN:. Returns true
+  // when the press was consumed by learning/forgetting.
+  static bool capture(uint8_t protocol, uint16_t address, uint16_t command);
+
+  // True while LEARN: or LEARN:FORGET waits for a press
+  static bool isLearning() { return learnState != LEARN_IDLE; }
+
+  // Command processing (text after the "LEARN:" prefix)
+  static bool processCommand(char* args);
+  static void printTable();
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * IdleSleep.cpp - Idle sleep implementation
+ */
+
+#include "IdleSleep.h"
+#include <avr/sleep.h>
+#include <avr/power.h>
+
+uint8_t IdleSleep::wakeMask = 0;
+uint32_t IdleSleep::sleeps = 0;
+uint32_t IdleSleep::sleptMicros = 0;
+
+// Wake-up only: returning from the ISR is what ends sleep_cpu()
+ISR(PCINT2_vect) {
+}
+
+void IdleSleep::begin(uint8_t wakePin) {
+  wakeMask = (wakePin < 8) ? _BV(wakePin) : 0; // PD0-PD7 = PCINT16-23
+
+  // Nothing in the sketch reads analog inputs or uses SPI/TWI
+  ADCSRA &= ~_BV(ADEN);
+  power_adc_disable();
+  power_spi_disable();
+  power_twi_disable();
+
+  set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+unsigned long IdleSleep::sleep() {
+  unsigned long started = micros();
+
+  // Arm the pin-change wake with interrupts off: an edge after this point
+  // leaves PCIF2 set, so sleep_cpu() returns at once instead of missing it
+  cli();
+  PCIFR = _BV(PCIF2);
+  PCMSK2 |= wakeMask;
+  PCICR |= _BV(PCIE2);
+  sleep_enable();
+  sei();       // sei takes effect after the next instruction,
+  sleep_cpu(); // so no interrupt can slip in between
+  sleep_disable();
+
+  // IR edges only matter as a wake source - don't take one per edge awake
+  PCMSK2 &= ~wakeMask;
+
+  unsigned long elapsed = micros() - started;
+  sleeps++;
+  sleptMicros += elapsed;
+  return elapsed;
+}
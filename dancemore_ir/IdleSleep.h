@@ -0,0 +1,44 @@
+/*
+ * IdleSleep.h - Sleep between IR edges and serial bytes when nothing runs
+ *
+ * When no effect is animating and every queue is drained, loop() parks the
+ * CPU in SLEEP_MODE_IDLE instead of busy-waiting in delayMicroseconds().
+ * Idle mode keeps the UART and Timer0 running, so the CPU wakes on:
+ * - a pin change on the IR receiver pin (enabled only while asleep)
+ * - a received serial byte (USART RX interrupt)
+ * - the Timer0 tick (~1ms), which also keeps millis()/micros() and the
+ *   scheduler deadlines valid
+ *
+ * The caller stops the IR receive timer around sleep() - its 50us tick
+ * would otherwise wake the CPU 20000 times a second.
+ */
+
+#ifndef IDLE_SLEEP_H
+#define IDLE_SLEEP_H
+
+#include <Arduino.h>
+
+#ifndef ENABLE_IDLE_SLEEP
+#define ENABLE_IDLE_SLEEP 1
+#endif
+
+class IdleSleep {
+private:
+  static uint8_t wakeMask;   // PCMSK2 bit of the wake pin
+  static uint32_t sleeps;
+  static uint32_t sleptMicros;
+
+public:
+  // Configure the wake pin (must be on port D, pins 0-7) and power down
+  // unused peripherals (ADC, SPI, TWI). Call once from setup.
+  static void begin(uint8_t wakePin);
+
+  // Sleep until the next interrupt. Returns the microseconds spent asleep.
+  static unsigned long sleep();
+
+  // Counters for STAT:
+  static uint32_t sleepCount() { return sleeps; }
+  static uint32_t totalSleptMicros() { return sleptMicros; }
+};
+
+#endif
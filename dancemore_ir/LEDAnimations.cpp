@@ -4,28 +4,49 @@
  */
 
 #include "LEDAnimations.h"
-
-// Define the static member variables declared in the header
-// These must match the declarations in LEDAnimations.h
-
-// Command table - stored in PROGMEM to save RAM
-const LEDCommand LEDAnimations::commands[] PROGMEM = {
-  {"off", ANIM_OFF, false},
+#include "BuildProfile.h"
+#include "FixedPoint.h"
+#include "LEDStrip.h"
+#include "TaskScheduler.h"
+
+// Command table - stored in PROGMEM to save RAM.
+// MUST stay sorted by name (byte order): findCommand() binary searches it,
+// and the static_assert below rejects an unsorted table at compile time.
+constexpr LEDCommand commands[] PROGMEM = {
   {"ack", ANIM_ACK, false},
+  {"custom", ANIM_CUSTOM, true},
+  {"fire", ANIM_FIRE, true},
+  {"matrix", ANIM_MATRIX, true},
   {"nack", ANIM_NACK, false},
+  {"ocean", ANIM_OCEAN, true},
+  {"off", ANIM_OFF, false},
+  {"pulse-blue", ANIM_PULSE_BLUE, true},
+  {"pulse-red", ANIM_PULSE_RED, true},
+  {"rainbow", ANIM_RAINBOW, true},
   {"red-blue", ANIM_RED_BLUE, true},
   {"red-green-yellow", ANIM_TRAFFIC, true},
-  {"matrix", ANIM_MATRIX, true},
-  {"rainbow", ANIM_RAINBOW, true},
-  {"pulse-red", ANIM_PULSE_RED, true},
-  {"pulse-blue", ANIM_PULSE_BLUE, true},
   {"strobe", ANIM_STROBE, true},
-  {"fire", ANIM_FIRE, true},
-  {"ocean", ANIM_OCEAN, true},
   {"thinking", ANIM_THINKING, true}
 };
 
-const int LEDAnimations::numCommands = sizeof(LEDAnimations::commands) / sizeof(LEDAnimations::commands[0]);
+const int numCommands = sizeof(commands) / sizeof(commands[0]);
+
+// Compile-time ordering check for the command table (matches strcmp_P order)
+constexpr bool commandNameLess(const char* a, const char* b) {
+  return (*a == *b) ? (*a != '\0' && commandNameLess(a + 1, b + 1))
+                    : ((unsigned char)*a < (unsigned char)*b);
+}
+
+constexpr bool commandsSorted(const LEDCommand* table, int count) {
+  return count < 2 || (commandNameLess(table[0].name, table[1].name) &&
+                       commandsSorted(table + 1, count - 1));
+}
+
+static_assert(commandsSorted(commands, sizeof(commands) / sizeof(commands[0])),
+              "LED commands[] must be sorted by name for binary search");
+
+// Define the static member variables declared in the header
+// These must match the declarations in LEDAnimations.h
 
 // Improved Rainbow color lookup table - 64 entries for smooth looping
 // Power of 2 size for efficient bit-masking: index & 63
@@ -55,7 +76,7 @@ const uint8_t LEDAnimations::rainbowTable[][3] PROGMEM = {
   {255,0,64}, {255,0,32}
 };
 
-const uint8_t LEDAnimations::RAINBOW_TABLE_SIZE = 64;
+const uint8_t LEDAnimations::RAINBOW_TABLE_SIZE = 1 << RAINBOW_TABLE_LOG2;
 
 #define SINE_LOOKUP_SIZE 64
 
@@ -71,27 +92,74 @@ const uint8_t LEDAnimations::sineLookup[64] PROGMEM = {
 };
 
 // Animation timing lookup table in PROGMEM
+// fadeStep: how long ColorPipeline blends into each new step's color.
+// Hard-cut effects (police, traffic, strobe, ack) use 0.
 struct AnimationTiming {
   uint8_t animType;
   uint16_t interval;
   uint16_t briefDuration; // For ack/nack
+  uint16_t fadeStep;
 };
 
 const AnimationTiming timingTable[] PROGMEM = {
-  {ANIM_ACK, 100, 300},
-  {ANIM_NACK, 100, 300},
-  {ANIM_RED_BLUE, 150, 0},
-  {ANIM_TRAFFIC, 800, 0},
-  {ANIM_MATRIX, 50, 0},
-  {ANIM_RAINBOW, 50, 0},
-  {ANIM_PULSE_RED, 30, 0},
-  {ANIM_PULSE_BLUE, 30, 0},
-  {ANIM_STROBE, 100, 0},
-  {ANIM_FIRE, 80, 0},
-  {ANIM_OCEAN, 40, 0},
-  {ANIM_THINKING, 200, 0}
+  {ANIM_ACK, 100, 300, 0},
+  {ANIM_NACK, 100, 300, 0},
+  {ANIM_RED_BLUE, 150, 0, 0},
+  {ANIM_TRAFFIC, 800, 0, 0},
+  {ANIM_MATRIX, 50, 0, colorFadeStep(50)},
+  {ANIM_RAINBOW, 50, 0, colorFadeStep(50)},
+  {ANIM_PULSE_RED, 30, 0, colorFadeStep(30)},
+  {ANIM_PULSE_BLUE, 30, 0, colorFadeStep(30)},
+  {ANIM_STROBE, 100, 0, 0},
+  {ANIM_FIRE, 80, 0, colorFadeStep(40)},
+  {ANIM_OCEAN, 40, 0, colorFadeStep(40)},
+  {ANIM_THINKING, 200, 0, colorFadeStep(150)},
+  {ANIM_CUSTOM, 100, 0, 0}
+};
+
+// Keyframe tracks - each effect is data for stepKeyframes() instead of a case
+const Keyframe redBlueFrames[] PROGMEM = {
+  {255, 0, 0, 0, 150, 0},              // Red
+  {0, 0, 255, KEYFRAME_LOOP, 150, 0}   // Blue
+};
+
+const Keyframe trafficFrames[] PROGMEM = {
+  {255, 0, 0, 0, 800, 0},              // Red
+  {0, 255, 0, 0, 800, 0},              // Green
+  {255, 255, 0, KEYFRAME_LOOP, 800, 0} // Yellow
+};
+
+const Keyframe strobeFrames[] PROGMEM = {
+  {255, 255, 255, 0, 100, 0},          // White
+  {0, 0, 0, KEYFRAME_LOOP, 100, 0}     // Off
 };
 
+// Simon-like sequence: each color fades in (108), holds (180), fades out (72)
+#define THINKING_FADE colorFadeStep(150)
+const Keyframe thinkingFrames[] PROGMEM = {
+  {0, 108, 0, 0, 200, THINKING_FADE}, {0, 180, 0, 0, 200, THINKING_FADE}, {0, 72, 0, 0, 200, THINKING_FADE},       // Green
+  {108, 0, 0, 0, 200, THINKING_FADE}, {180, 0, 0, 0, 200, THINKING_FADE}, {72, 0, 0, 0, 200, THINKING_FADE},       // Red
+  {108, 108, 0, 0, 200, THINKING_FADE}, {180, 180, 0, 0, 200, THINKING_FADE}, {72, 72, 0, 0, 200, THINKING_FADE},  // Yellow
+  {0, 0, 108, 0, 200, THINKING_FADE}, {0, 0, 180, 0, 200, THINKING_FADE}, {0, 0, 72, KEYFRAME_LOOP, 200, THINKING_FADE} // Blue
+};
+
+struct KeyframeTrack {
+  uint8_t animType;
+  const Keyframe* frames;
+  uint8_t count;
+};
+
+#define KEYFRAME_TRACK(type, frames) {type, frames, sizeof(frames) / sizeof(Keyframe)}
+
+const KeyframeTrack keyframeTracks[] PROGMEM = {
+  KEYFRAME_TRACK(ANIM_RED_BLUE, redBlueFrames),
+  KEYFRAME_TRACK(ANIM_TRAFFIC, trafficFrames),
+  KEYFRAME_TRACK(ANIM_STROBE, strobeFrames),
+  KEYFRAME_TRACK(ANIM_THINKING, thinkingFrames)
+};
+
+const int numKeyframeTracks = sizeof(keyframeTracks) / sizeof(keyframeTracks[0]);
+
 const int numTimings = sizeof(timingTable) / sizeof(timingTable[0]);
 
 
@@ -106,57 +174,85 @@ LEDAnimations::LEDAnimations(int redPin, int greenPin, int bluePin) {
   lastAnimationUpdate = 0;
   animationStep = 0;
   animationInterval = 500;
+  fadeStep = 0;
   animationIndex = 0;   // Initialize new integer index for sine waves
   animationIndex2 = 0;  // Initialize second integer index for ocean effect
   ackFlashState = false;
+  brightness = 255;
   debugMode = false;
+  keyframes = nullptr;
+  keyframeCount = 0;
+  keyframesInFlash = true;
+  customKeyframeCount = 0;
 }
 
 
 void LEDAnimations::begin(bool debugMode) {
   this->debugMode = debugMode;
 
-  // Initialize RGB LED pins
-  pinMode(redPin, OUTPUT);
-  pinMode(greenPin, OUTPUT);
-  pinMode(bluePin, OUTPUT);
+  // Initialize the output backend: a WS2812 strip, or the RGB LED pins and
+  // the interrupt-driven fade pipeline
+  if (BuildProfile::ledStrip) {
+    LEDStrip::begin(LED_STRIP_PIN);
+  } else {
+    ColorPipeline::begin(redPin, greenPin, bluePin);
+  }
   setColor(0, 0, 0); // Start with LED off
 }
 
 
-// Get rainbow color by index (0-59) - replaces HSV conversion
-void LEDAnimations::getRainbowColor(uint8_t index, uint8_t &r, uint8_t &g, uint8_t &b) {
-  index = index % RAINBOW_TABLE_SIZE;
-  r = pgm_read_byte(&rainbowTable[index][0]);
-  g = pgm_read_byte(&rainbowTable[index][1]);
-  b = pgm_read_byte(&rainbowTable[index][2]);
+// Sample the rainbow at a 16-bit position around the hue circle - the top
+// 6 bits pick the table entry, the next 8 blend toward its neighbour
+void LEDAnimations::getRainbowColor(uint16_t position, uint8_t &r, uint8_t &g, uint8_t &b) {
+  paletteColor(rainbowTable, RAINBOW_TABLE_LOG2, position, r, g, b);
 }
 
-// Set RGB LED color (Common Anode - inverted logic)
+// Set RGB LED color - the master dimmer is applied here, ColorPipeline
+// handles gamma and common anode inversion. A strip shows it on every pixel
+// (hard cut - the strip backend has no fade pipeline).
 void LEDAnimations::setColor(uint8_t red, uint8_t green, uint8_t blue) {
-  analogWrite(redPin, 255 - red);
-  analogWrite(greenPin, 255 - green);
-  analogWrite(bluePin, 255 - blue);
+  if (BuildProfile::ledStrip) {
+    LEDStrip::fill(scale8(red, brightness), scale8(green, brightness), scale8(blue, brightness));
+    return;
+  }
+  ColorPipeline::setTarget(scale8(red, brightness), scale8(green, brightness),
+                           scale8(blue, brightness), fadeStep);
+}
+
+void LEDAnimations::setBrightness(uint8_t level) {
+  brightness = level;
 }
 
 // Update LED animation
 void LEDAnimations::update() {
-  unsigned long currentTime = millis();
+  update(millis());
+}
 
+void LEDAnimations::update(unsigned long currentTime) {
   // Check if animation should end
   if (animationEndTime > 0 && currentTime > animationEndTime) {
     animationMode = ANIM_OFF;
+    fadeStep = 0;
     setColor(0, 0, 0);
     return;
   }
 
-  // Check if it's time to update animation
-  if (currentTime - lastAnimationUpdate < animationInterval) {
+  // Check if it's time to update animation (exact timingTable cadence)
+  if (!stepCadence(lastAnimationUpdate, currentTime, animationInterval)) {
     return;
   }
 
-  lastAnimationUpdate = currentTime;
+  step();
+}
+
+// Perform one animation step for the current mode
+void LEDAnimations::step() {
+  if (keyframes != nullptr) {
+    stepKeyframes();
+    return;
+  }
 
+  // Computed effects bail out first so lean builds drop their code and tables
   switch (animationMode) {
     case ANIM_ACK: // Quick acknowledgment flash
       if (animationStep == 0) {
@@ -184,78 +280,63 @@ void LEDAnimations::update() {
       animationStep++;
       break;
 
-    case ANIM_RED_BLUE: // red-blue police style
-      if (animationStep % 2 == 0) {
-        setColor(255, 0, 0); // Red
-      } else {
-        setColor(0, 0, 255); // Blue
-      }
-      animationStep++;
-      break;
-
-    case ANIM_TRAFFIC: // red-green-yellow traffic light
-      switch (animationStep % 3) {
-        case 0: setColor(255, 0, 0); break;  // Red
-        case 1: setColor(0, 255, 0); break;  // Green
-        case 2: setColor(255, 255, 0); break; // Yellow
-      }
-      animationStep++;
-      break;
-
     case ANIM_MATRIX: // Matrix effect - green fade using sine lookup
       {
+        if (!BuildProfile::computedLedEffects) break;
         // Read intensity from PROGMEM sine table
         uint8_t green = pgm_read_byte(&sineLookup[animationIndex]);
         setColor(0, green, 0);
         // Increment index for next step, wrap around table size
-        animationIndex = (animationIndex + 1) % SINE_LOOKUP_SIZE;
+        animationIndex = (animationIndex + 1) & (SINE_LOOKUP_SIZE - 1);
       }
       break;
 
     case ANIM_RAINBOW: // Rainbow using lookup table
       {
-        uint8_t r, g, b;
-        uint8_t colorIndex = animationStep % RAINBOW_TABLE_SIZE;
-        getRainbowColor(colorIndex, r, g, b);
-        setColor(r, g, b);
-        animationStep++;
+        if (!BuildProfile::computedLedEffects) break;
+        // One table entry per step - animationStep wraps with the position
+        uint16_t position = (uint16_t)animationStep << (16 - RAINBOW_TABLE_LOG2);
+        if (BuildProfile::ledStrip) {
+          // Chase: the whole hue circle spread across the strip
+          LEDStrip::rainbowChase(rainbowTable, RAINBOW_TABLE_LOG2, position,
+                                 (uint16_t)(0x10000UL / LEDStrip::PIXELS), brightness);
+        } else {
+          uint8_t r, g, b;
+          getRainbowColor(position, r, g, b);
+          setColor(r, g, b);
+        }
+        animationStep = (animationStep + 1) & (RAINBOW_TABLE_SIZE - 1);
       }
       break;
 
     case ANIM_PULSE_RED: // Pulse red using sine lookup
       {
+        if (!BuildProfile::computedLedEffects) break;
         // Read intensity from PROGMEM sine table
         uint8_t red = pgm_read_byte(&sineLookup[animationIndex]);
         setColor(red, 0, 0);
         // Increment index for next step (faster pulse), wrap around table size
-        animationIndex = (animationIndex + 2) % SINE_LOOKUP_SIZE; 
+        animationIndex = (animationIndex + 2) & (SINE_LOOKUP_SIZE - 1);
       }
       break;
 
     case ANIM_PULSE_BLUE: // Pulse blue using sine lookup
       {
+        if (!BuildProfile::computedLedEffects) break;
         // Read intensity from PROGMEM sine table
         uint8_t blue = pgm_read_byte(&sineLookup[animationIndex]);
         setColor(0, 0, blue);
         // Increment index for next step (faster pulse), wrap around table size
-        animationIndex = (animationIndex + 2) % SINE_LOOKUP_SIZE;
-      }
-      break;
-
-    case ANIM_STROBE: // Strobe white
-      if (animationStep % 2 == 0) {
-        setColor(255, 255, 255); // White
-      } else {
-        setColor(0, 0, 0); // Off
+        animationIndex = (animationIndex + 2) & (SINE_LOOKUP_SIZE - 1);
       }
-      animationStep++;
       break;
 
     case ANIM_FIRE: // Fire effect
       {
-        // Random flicker between red and orange
-        uint8_t red = 200 + random(56);     // 200-255
-        uint8_t green = random(100);        // 0-99 for orange tint
+        if (!BuildProfile::computedLedEffects) break;
+        // Random flicker between red and orange - xorshift, no random() divide
+        uint8_t red = 200 + random8(56);    // 200-255
+        uint8_t green = random8(100);       // 0-99 for orange tint
         uint8_t blue = 0;
         setColor(red, green, blue);
       }
@@ -263,41 +344,25 @@ void LEDAnimations::update() {
 
     case ANIM_OCEAN: // Ocean wave effect using sine lookup
       {
-        // Read wave intensities from PROGMEM sine table using two different indices
-        uint8_t blue_intensity = pgm_read_byte(&sineLookup[animationIndex]);
-        uint8_t cyan_intensity = pgm_read_byte(&sineLookup[animationIndex2]);
-
-        // Scale cyan intensity to 0-100 range as per original logic
-        uint8_t blue = blue_intensity;
-        uint8_t cyan = (uint8_t)(cyan_intensity * 100 / 255); 
-        
-        setColor(0, cyan, blue);
+        if (!BuildProfile::computedLedEffects) break;
+        if (BuildProfile::ledStrip) {
+          // Same two waves, phase-shifted pixel by pixel along the strip
+          LEDStrip::oceanWave(sineLookup, animationIndex, animationIndex2, brightness);
+        } else {
+          // Read wave intensities from PROGMEM sine table using two different indices
+          uint8_t blue_intensity = pgm_read_byte(&sineLookup[animationIndex]);
+          uint8_t cyan_intensity = pgm_read_byte(&sineLookup[animationIndex2]);
 
-        // Increment indices for different wave speeds, wrap around table size
-        animationIndex = (animationIndex + 1) % SINE_LOOKUP_SIZE;
-        animationIndex2 = (animationIndex2 + 2) % SINE_LOOKUP_SIZE; // Faster wave for cyan
-      }
-      break;
+          // Scale cyan intensity to 0-100 range as per original logic
+          uint8_t blue = blue_intensity;
+          uint8_t cyan = scale8(cyan_intensity, 100);
 
-    case ANIM_THINKING: // Thinking - Simon-like sequence
-      {
-        // Cycle through: green, red, yellow, blue with smooth fade
-        int colorIndex = (animationStep / 3) % 4; // Each color lasts 3 steps
-        int fadeStep = animationStep % 3;         // 0=fade in, 1=hold, 2=fade out
-        
-        // This still uses float for intensity calculation. If further memory optimization
-        // is needed, this could also be replaced with a small lookup table or
-        // fixed-point arithmetic if the exact values are critical.
-        float intensity_float = (fadeStep == 0) ? 0.6 : (fadeStep == 1) ? 1.0 : 0.4;
-        uint8_t brightness = (uint8_t)(intensity_float * 180); // Not full brightness for subtlety
-        
-        switch (colorIndex) {
-          case 0: setColor(0, brightness, 0); break;          // Green
-          case 1: setColor(brightness, 0, 0); break;          // Red 
-          case 2: setColor(brightness, brightness, 0); break; // Yellow
-          case 3: setColor(0, 0, brightness); break;          // Blue
+          setColor(0, cyan, blue);
         }
-        animationStep++;
+
+        // Increment indices for different wave speeds, wrap around table size
+        animationIndex = (animationIndex + 1) & (SINE_LOOKUP_SIZE - 1);
+        animationIndex2 = (animationIndex2 + 2) & (SINE_LOOKUP_SIZE - 1); // Faster wave for cyan
       }
       break;
 
@@ -307,8 +372,72 @@ void LEDAnimations::update() {
   }
 }
 
+// Apply the current keyframe; its hold time becomes the next update interval
+void LEDAnimations::stepKeyframes() {
+  if (animationStep >= keyframeCount) {
+    off(); // Non-looping track finished
+    return;
+  }
+
+  Keyframe frame;
+  if (keyframesInFlash) {
+    memcpy_P(&frame, &keyframes[animationStep], sizeof(Keyframe));
+  } else {
+    frame = keyframes[animationStep];
+  }
+
+  fadeStep = frame.fadeStep;
+  setColor(frame.red, frame.green, frame.blue);
+  animationInterval = frame.holdMillis;
+
+  animationStep++;
+  if (animationStep >= keyframeCount && (frame.flags & KEYFRAME_LOOP)) {
+    animationStep = 0;
+  }
+}
+
+// Append a keyframe to the custom track: "r g b hold_ms fade_ms"
+bool LEDAnimations::addCustomKeyframe(char* args) {
+  if (customKeyframeCount >= MAX_CUSTOM_KEYFRAMES) {
+    if (BuildProfile::debug(debugMode)) Serial.println(F("Custom track full (LED:key-clear to reset)"));
+    return true;
+  }
+
+  char* cursor = args;
+  Keyframe& frame = customKeyframes[customKeyframeCount];
+  frame.red = constrain(atoi(nextToken(cursor, ' ')), 0, 255);
+  frame.green = constrain(atoi(nextToken(cursor, ' ')), 0, 255);
+  frame.blue = constrain(atoi(nextToken(cursor, ' ')), 0, 255);
+  frame.holdMillis = constrain(atol(nextToken(cursor, ' ')), 10, 30000);
+  frame.fadeStep = colorFadeStep(constrain(atol(nextToken(cursor, ' ')), 0, 30000));
+  frame.flags = KEYFRAME_LOOP; // Uploaded tracks always loop
+
+  // Only the last frame carries the loop flag
+  if (customKeyframeCount > 0) {
+    customKeyframes[customKeyframeCount - 1].flags &= ~KEYFRAME_LOOP;
+  }
+  customKeyframeCount++;
+
+  // Playing the custom track: extend it, or its old last frame - no longer
+  // looping - would end playback after one pass
+  if (keyframes == customKeyframes) {
+    keyframeCount = customKeyframeCount;
+  }
+
+  if (BuildProfile::debug(debugMode)) {
+    Serial.print(F("Custom keyframe "));
+    Serial.print(customKeyframeCount);
+    Serial.print('/');
+    Serial.println(MAX_CUSTOM_KEYFRAMES);
+  }
+  return true;
+}
+
 // Start LED animation - optimized with lookup table
 void LEDAnimations::startAnimation(int animType, int durationSeconds) {
+  if (!isBuiltIn(animType)) {
+    animType = ANIM_OFF; // Compiled out of this build profile
+  }
   animationMode = (AnimationMode)animType; // Cast to enum type
   animationStep = 0;
   animationIndex = 0;   // Reset sine lookup index
@@ -319,6 +448,7 @@ void LEDAnimations::startAnimation(int animType, int durationSeconds) {
   for (int i = 0; i < numTimings; i++) {
     if (pgm_read_byte(&timingTable[i].animType) == animType) {
       animationInterval = pgm_read_word(&timingTable[i].interval);
+      fadeStep = pgm_read_word(&timingTable[i].fadeStep);
       uint16_t briefDuration = pgm_read_word(&timingTable[i].briefDuration);
       
       if (briefDuration > 0) {
@@ -332,12 +462,36 @@ void LEDAnimations::startAnimation(int animType, int durationSeconds) {
     }
   }
 
+  // Data-driven effects play a keyframe track
+  keyframes = nullptr;
+  keyframeCount = 0;
+  if (animType == ANIM_CUSTOM) {
+    if (customKeyframeCount > 0) {
+      keyframes = customKeyframes;
+      keyframeCount = customKeyframeCount;
+      keyframesInFlash = false;
+    } else {
+      animationMode = ANIM_OFF; // Nothing uploaded yet
+      animType = ANIM_OFF;
+    }
+  } else {
+    for (int i = 0; i < numKeyframeTracks; i++) {
+      if (pgm_read_byte(&keyframeTracks[i].animType) == animType) {
+        keyframes = (const Keyframe*)pgm_read_ptr(&keyframeTracks[i].frames);
+        keyframeCount = pgm_read_byte(&keyframeTracks[i].count);
+        keyframesInFlash = true;
+        break;
+      }
+    }
+  }
+
   if (animType == ANIM_OFF) {
     animationEndTime = 0;
+    fadeStep = 0;
     setColor(0, 0, 0);
   }
 
-  if (debugMode && animType != ANIM_ACK && animType != ANIM_NACK) {
+  if (BuildProfile::debug(debugMode) && animType != ANIM_ACK && animType != ANIM_NACK) {
     Serial.print(F("LED animation started: mode "));
     Serial.print(animType);
     if (durationSeconds > 0) {
@@ -363,7 +517,10 @@ void LEDAnimations::flashNack() {
 // Turn off LED
 void LEDAnimations::off() {
   animationMode = ANIM_OFF;
+  keyframes = nullptr;
+  keyframeCount = 0;
   animationEndTime = 0;
+  fadeStep = 0;
   setColor(0, 0, 0);
 }
 
@@ -372,49 +529,110 @@ bool LEDAnimations::isAnimating() {
   return (animationMode != ANIM_OFF);
 }
 
-// Process LED command - optimized for flash memory
-bool LEDAnimations::processCommand(const String& command) {
-  if (!command.startsWith(F("LED:"))) {
-    return false;
+bool LEDAnimations::isBuiltIn(uint8_t animationType) {
+  switch (animationType) {
+    case ANIM_MATRIX:
+    case ANIM_RAINBOW:
+    case ANIM_PULSE_RED:
+    case ANIM_PULSE_BLUE:
+    case ANIM_FIRE:
+    case ANIM_OCEAN:
+      return BuildProfile::computedLedEffects;
+    default:
+      return true;
+  }
+}
+
+// Find a command by name - O(log n) strcmp_P probes regardless of table position
+const LEDCommand* LEDAnimations::findCommand(const char* name) {
+  int low = 0;
+  int high = numCommands - 1;
+
+  while (low <= high) {
+    int mid = (low + high) / 2;
+    int cmp = strcmp_P(name, commands[mid].name);
+    if (cmp == 0) {
+      return isBuiltIn(pgm_read_byte(&commands[mid].animationType)) ? &commands[mid] : nullptr;
+    } else if (cmp < 0) {
+      high = mid - 1;
+    } else {
+      low = mid + 1;
+    }
   }
+  return nullptr;
+}
+
+uint8_t LEDAnimations::commandCount() {
+  return numCommands;
+}
+
+const __FlashStringHelper* LEDAnimations::commandName(uint8_t index) {
+  return (const __FlashStringHelper*)commands[index].name;
+}
 
-  String param = command.substring(4);
+int LEDAnimations::animationForName(const char* name) {
+  const LEDCommand* entry = findCommand(name);
+  return (entry != nullptr) ? pgm_read_byte(&(entry->animationType)) : -1;
+}
 
-  // Check each command in the table
+const __FlashStringHelper* LEDAnimations::animationName(uint8_t animationType) {
   for (int i = 0; i < numCommands; i++) {
-    char cmdName[20];
-    strcpy_P(cmdName, (char*)pgm_read_ptr(&(commands[i].name)));
+    if (pgm_read_byte(&(commands[i].animationType)) == animationType) {
+      return (const __FlashStringHelper*)commands[i].name;
+    }
+  }
+  return nullptr;
+}
 
-    bool requiresDuration = pgm_read_byte(&(commands[i].requiresDuration));
-    uint8_t animationType = pgm_read_byte(&(commands[i].animationType));
+// Process LED command - tokenized in place, no String building
+bool LEDAnimations::processCommand(char* args) {
+  char* cursor = args;
+  char* name = nextToken(cursor, ' ');
+
+  // Custom keyframe track editing
+  if (strcmp_P(name, PSTR("key-add")) == 0) {
+    return addCustomKeyframe(cursor);
+  }
+  if (strcmp_P(name, PSTR("key-clear")) == 0) {
+    if (animationMode == ANIM_CUSTOM) off();
+    customKeyframeCount = 0;
+    return true;
+  }
+
+  // Master dimmer, applied to every effect as it posts its color
+  if (strcmp_P(name, PSTR("dim")) == 0) {
+    int level = atoi(cursor);
+    if (*cursor == '\0' || level < 0 || level > 255) {
+      if (BuildProfile::debug(debugMode)) Serial.println(F("LED:dim expects 0-255"));
+      return true;
+    }
+    setBrightness(level);
+    return true;
+  }
+
+  const LEDCommand* entry = findCommand(name);
+  if (entry != nullptr) {
+    bool requiresDuration = pgm_read_byte(&(entry->requiresDuration));
+    uint8_t animationType = pgm_read_byte(&(entry->animationType));
 
     if (requiresDuration) {
-      String cmdNameStr = String(cmdName) + " ";
-      if (param.startsWith(cmdNameStr)) {
-        int duration = param.substring(cmdNameStr.length()).toInt();
-        if (duration > 0) {
-          startAnimation(animationType, duration);
-          return true;
-        } else if (debugMode) {
-          Serial.print(F("Invalid duration for "));
-          Serial.print(cmdName);
-          Serial.println(F(" animation"));
-        }
-        return true;
+      int duration = atoi(cursor);
+      if (duration > 0) {
+        startAnimation(animationType, duration);
+      } else if (BuildProfile::debug(debugMode)) {
+        Serial.print(F("Invalid duration for "));
+        Serial.print(name);
+        Serial.println(F(" animation"));
       }
+    } else if (animationType == ANIM_OFF) {
+      off();
     } else {
-      if (param == cmdName) {
-        if (animationType == ANIM_OFF) {
-          off();
-        } else {
-          startAnimation(animationType, 0);
-        }
-        return true;
-      }
+      startAnimation(animationType, 0);
     }
+    return true;
   }
 
-  if (debugMode) {
+  if (BuildProfile::debug(debugMode)) {
     printHelp();
   }
   return true;
@@ -424,16 +642,17 @@ bool LEDAnimations::processCommand(const String& command) {
 void LEDAnimations::printHelp() {
   Serial.println(F("LED commands:"));
   for (int i = 0; i < numCommands; i++) {
-    char cmdName[20];
-    strcpy_P(cmdName, (char*)pgm_read_ptr(&(commands[i].name)));
     bool requiresDuration = pgm_read_byte(&(commands[i].requiresDuration));
 
     Serial.print(F("  LED:"));
-    Serial.print(cmdName);
+    Serial.print((const __FlashStringHelper*)commands[i].name);
     if (requiresDuration) {
       Serial.println(F(" <duration>"));
     } else {
       Serial.println();
     }
   }
+  Serial.println(F("  LED:key-add <r> <g> <b> <hold_ms> <fade_ms>"));
+  Serial.println(F("  LED:key-clear"));
+  Serial.println(F("  LED:dim <0-255>"));
 }
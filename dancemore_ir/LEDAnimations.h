@@ -9,6 +9,8 @@
 
 #include <Arduino.h>
 #include <avr/pgmspace.h> // Required for PROGMEM
+#include "CommandRegistry.h"
+#include "ColorPipeline.h"
 
 // Animation mode constants
 enum AnimationMode {
@@ -24,12 +26,31 @@ enum AnimationMode {
   ANIM_STROBE,
   ANIM_FIRE,
   ANIM_OCEAN,
-  ANIM_THINKING
+  ANIM_THINKING,
+  ANIM_CUSTOM    // Keyframes uploaded over serial (LED:key-add)
 };
 
-// Command structure for LED animations
+// Keyframe flags
+#define KEYFRAME_LOOP 0x01 // On the last frame: restart the track instead of ending
+
+// One step of a keyframe animation: jump/fade to a color, then hold.
+// holdMillis is the time until the next keyframe; the fade (fadeStep from
+// colorFadeStep()) runs at the start of it in ColorPipeline.
+struct Keyframe {
+  uint8_t red, green, blue;
+  uint8_t flags;
+  uint16_t holdMillis;
+  uint16_t fadeStep;
+};
+
+#define MAX_CUSTOM_KEYFRAMES 8
+
+#define LED_COMMAND_NAME_MAX 17 // Longest name ("red-green-yellow") + terminator
+
+// Command structure for LED animations - name stored inline so the whole
+// entry lives in PROGMEM and can be compared with strcmp_P
 struct LEDCommand {
-  const char* name;
+  char name[LED_COMMAND_NAME_MAX];
   uint8_t animationType; // Changed to uint8_t for consistency with enum
   bool requiresDuration;
 };
@@ -45,22 +66,38 @@ private:
   unsigned long lastAnimationUpdate;
   int animationStep;
   int animationInterval;
+  uint16_t fadeStep;        // ColorPipeline fade per step (0 = hard cut)
   uint8_t animationIndex;   // New: Integer index for sine wave animations
   uint8_t animationIndex2;  // New: Second integer index for ocean effect
   bool ackFlashState;
   bool debugMode;
+  uint8_t brightness;       // Master dimmer, 255 = full
+
+  // Keyframe interpreter state - animationStep doubles as the frame index
+  const Keyframe* keyframes; // nullptr when the mode is a hand-written effect
+  uint8_t keyframeCount;
+  bool keyframesInFlash;
+
+  // Serial-uploaded keyframe track played by ANIM_CUSTOM
+  Keyframe customKeyframes[MAX_CUSTOM_KEYFRAMES];
+  uint8_t customKeyframeCount;
   
-  // Command table - automatically expandable
-  static const LEDCommand commands[];
-  static const int numCommands;
+  // Binary search of the sorted command table - nullptr if not found
+  static const LEDCommand* findCommand(const char* name);
   
   // Internal methods
   // Removed hsvToRgb as it's no longer used with the lookup table approach
+  // Posts a target to ColorPipeline; the timer ISR fades to it
   void setColor(uint8_t red, uint8_t green, uint8_t blue);
-  void getRainbowColor(uint8_t index, uint8_t &r, uint8_t &g, uint8_t &b);
+  void getRainbowColor(uint16_t position, uint8_t &r, uint8_t &g, uint8_t &b);
+
+  // Keyframe interpreter - applies the next frame and schedules the one after
+  void stepKeyframes();
+  bool addCustomKeyframe(char* args);
 
   // PROGMEM tables
   static const uint8_t rainbowTable[][3]; // Declaration for rainbow table
+  static const uint8_t RAINBOW_TABLE_LOG2 = 6; // 64 entries - power of two so indices wrap with a mask
   static const uint8_t RAINBOW_TABLE_SIZE; // Declaration for rainbow table size
   static const uint8_t sineLookup[]; // New: Declaration for sine lookup table
   
@@ -70,16 +107,34 @@ public:
   
   // Public methods
   void begin(bool debugMode = false);
+  void setDebugMode(bool debug) { debugMode = debug; }
+  bool isDebugMode() const { return debugMode; }
   void update();
+  void update(unsigned long now); // Shared timebase from SceneEngine
+  void step(); // One animation step now, ignoring the interval (update() calls this when due)
   void startAnimation(int animType, int durationSeconds);
   void flashAck();
   void flashNack();
   void off();
   bool isAnimating();
+
+  // Master dimmer (0-255) scaling every color the effects post
+  void setBrightness(uint8_t level);
   
-  // Command processing
-  bool processCommand(const String& command);
+  // Command processing (text after the "LED:" prefix, tokenized in place)
+  bool processCommand(char* args);
   void printHelp();
+
+  // Command table access (names are PROGMEM strings)
+  static uint8_t commandCount();
+  static const __FlashStringHelper* commandName(uint8_t index);
+
+  // Animation type for a command name (-1 if unknown), and the reverse
+  static int animationForName(const char* name);
+  static const __FlashStringHelper* animationName(uint8_t animationType);
+
+  // False for effects compiled out by the build profile (BuildProfile.h)
+  static bool isBuiltIn(uint8_t animationType);
 };
 
 #endif
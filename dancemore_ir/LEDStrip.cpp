@@ -0,0 +1,140 @@
+/*
+ * LEDStrip.cpp - WS2812 addressable strip backend implementation
+ */
+
+#include "LEDStrip.h"
+#include "FixedPoint.h"
+#include <avr/interrupt.h>
+
+uint8_t LEDStrip::frame[PIXELS * 3];
+volatile uint8_t* LEDStrip::port;
+uint8_t LEDStrip::pinMask;
+bool LEDStrip::dirty = false;
+unsigned long LEDStrip::lastPushMillis = 0;
+uint16_t LEDStrip::framesPushed = 0;
+uint16_t LEDStrip::framesDeferred = 0;
+uint16_t LEDStrip::rxOverruns = 0;
+
+void LEDStrip::begin(uint8_t dataPin) {
+  pinMode(dataPin, OUTPUT);
+  digitalWrite(dataPin, LOW);
+  port = portOutputRegister(digitalPinToPort(dataPin));
+  pinMask = digitalPinToBitMask(dataPin);
+
+  fill(0, 0, 0);
+  push(); // Strips power up showing garbage - blank it before the frame cap starts
+  lastPushMillis = millis();
+}
+
+void LEDStrip::fill(uint8_t red, uint8_t green, uint8_t blue) {
+  uint8_t* out = frame;
+  for (uint8_t i = 0; i < PIXELS; i++) {
+    *out++ = green;
+    *out++ = red;
+    *out++ = blue;
+  }
+  dirty = true;
+}
+
+void LEDStrip::rainbowChase(const uint8_t (*palette)[3], uint8_t sizeLog2,
+                            uint16_t position, uint16_t spacing, uint8_t brightness) {
+  uint8_t* out = frame;
+  for (uint8_t i = 0; i < PIXELS; i++) {
+    uint8_t r, g, b;
+    paletteColor(palette, sizeLog2, position, r, g, b);
+    *out++ = scale8(g, brightness);
+    *out++ = scale8(r, brightness);
+    *out++ = scale8(b, brightness);
+    position += spacing; // Wraps around the hue circle on its own
+  }
+  dirty = true;
+}
+
+void LEDStrip::oceanWave(const uint8_t* sineTable, uint8_t blueIndex, uint8_t cyanIndex,
+                         uint8_t brightness) {
+  uint8_t cyanScale = scale8(100, brightness);
+  uint8_t* out = frame;
+  for (uint8_t i = 0; i < PIXELS; i++) {
+    *out++ = scale8(pgm_read_byte(&sineTable[cyanIndex & 63]), cyanScale);
+    *out++ = 0;
+    *out++ = scale8(pgm_read_byte(&sineTable[blueIndex & 63]), brightness);
+    blueIndex += 2; // Blue rolls toward the far end...
+    cyanIndex -= 3; // ...cyan back toward the near end, a little tighter
+  }
+  dirty = true;
+}
+
+bool LEDStrip::show(bool receiverIdle, unsigned long rxQuietMicros) {
+  if (!dirty) {
+    return false;
+  }
+  unsigned long now = millis();
+  if (now - lastPushMillis < LED_STRIP_FRAME_MILLIS) {
+    return false;
+  }
+  if (!receiverIdle || rxQuietMicros < PUSH_MICROS) {
+    if (framesDeferred < 0xFFFF) framesDeferred++;
+    return false;
+  }
+
+  push();
+  dirty = false;
+  lastPushMillis = now;
+  if (framesPushed < 0xFFFF) framesPushed++;
+  return true;
+}
+
+// 800 kHz bit-bang for a 16 MHz part: 20 cycles per bit, high for 4 cycles
+// (0.25us) on a 0 and 14 cycles (0.875us) on a 1. The port value for both
+// levels is precomputed so each edge is a single 2-cycle store.
+void LEDStrip::push() {
+  volatile uint8_t* out = port;
+  const uint8_t* ptr = frame;
+  uint16_t count = sizeof(frame);
+  uint8_t bit = 8;
+
+  uint8_t oldSREG = SREG;
+  cli();
+
+  uint8_t hi = *out | pinMask;
+  uint8_t lo = *out & ~pinMask;
+  uint8_t next = lo;
+  uint8_t byte = *ptr++;
+
+#if defined(__AVR__) // The native build under host/ just drops the frame
+  __asm__ volatile(
+    "1:"                        "\n\t" // Cycle (T = 0)
+    "st   %a[port], %[hi]"      "\n\t" // 2  line high            (T = 2)
+    "sbrc %[byte], 7"           "\n\t" // 1-2 top bit set?
+    "mov  %[next], %[hi]"       "\n\t" // 0-1  then stay high     (T = 4)
+    "dec  %[bit]"               "\n\t" // 1                       (T = 5)
+    "st   %a[port], %[next]"    "\n\t" // 2  low here for a 0     (T = 7)
+    "mov  %[next], %[lo]"       "\n\t" // 1                       (T = 8)
+    "breq 2f"                   "\n\t" // 1-2 last bit of the byte?
+    "rol  %[byte]"              "\n\t" // 1                       (T = 10)
+    "rjmp .+0"                  "\n\t" // 2                       (T = 12)
+    "nop"                       "\n\t" // 1                       (T = 13)
+    "st   %a[port], %[lo]"      "\n\t" // 2  low here for a 1     (T = 15)
+    "nop"                       "\n\t" // 1                       (T = 16)
+    "rjmp .+0"                  "\n\t" // 2                       (T = 18)
+    "rjmp 1b"                   "\n\t" // 2  next bit             (T = 20)
+    "2:"                        "\n\t" //                         (T = 10)
+    "ldi  %[bit], 8"            "\n\t" // 1                       (T = 11)
+    "ld   %[byte], %a[ptr]+"    "\n\t" // 2  fetch the next byte  (T = 13)
+    "st   %a[port], %[lo]"      "\n\t" // 2                       (T = 15)
+    "nop"                       "\n\t" // 1                       (T = 16)
+    "sbiw %[count], 1"          "\n\t" // 2                       (T = 18)
+    "brne 1b"                   "\n"   // 2  next byte            (T = 20)
+    : [port] "+e" (out), [ptr] "+e" (ptr), [byte] "+r" (byte), [bit] "+d" (bit),
+      [next] "+r" (next), [count] "+w" (count)
+    : [hi] "r" (hi), [lo] "r" (lo));
+#else
+  (void)out; (void)ptr; (void)count; (void)bit; (void)hi; (void)next; (void)byte;
+#endif
+
+  // The RX interrupt hasn't run yet, so DOR0 still shows whether a byte
+  // was lost while the line was masked
+  if ((UCSR0A & _BV(DOR0)) && rxOverruns < 0xFFFF) rxOverruns++;
+
+  SREG = oldSREG; // The line idles low - the strip latches after 50us
+}
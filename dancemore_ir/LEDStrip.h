@@ -0,0 +1,105 @@
+/*
+ * LEDStrip.h - WS2812 addressable strip backend for LEDAnimations
+ *
+ * Selected with LED_OUTPUT=LED_OUTPUT_STRIP (BuildProfile.h). Effects write
+ * a packed GRB framebuffer - a uniform fill, or a per-pixel kernel that
+ * computes the whole strip in one pass - and show() pushes it to the strip
+ * with interrupts masked for the whole frame, about 30us per pixel.
+ *
+ * Nothing else runs while the line is masked, so show() only pushes when:
+ * - the IR receiver is idle, i.e. not in the middle of capturing a frame;
+ * - the serial RX line has been quiet for at least one push time, and no
+ *   text line or binary frame is half received. The UART holds only ~2
+ *   bytes (~260us at 115200), so bytes arriving during a push would be
+ *   overrun;
+ * - LED_STRIP_FRAME_MILLIS has passed since the last push.
+ * A deferred frame stays dirty and goes out on a later call.
+ *
+ * What is still lost - the gates are heuristics, not a lock:
+ * - IR: a mark that starts during a push has its first up to
+ *   LEDStrip::PUSH_MICROS mismeasured, enough to break a SIRC or RC5
+ *   header. The remote's next repeat decodes normally.
+ * - Serial: a command the host starts sending during a push (a quiet gap
+ *   doesn't mean none is coming) loses the bytes past the UART's 2-byte
+ *   buffer, ~10 bytes per 900us push at 115200. The line arrives garbled
+ *   or a binary frame fails its CRC. Each push that ends with the UART
+ *   overrun flag set is counted (STAT: strip overruns=).
+ *
+ * Timer0 (millis) keeps one overflow pending while masked, so a push must
+ * stay under one 1024us overflow period: LED_STRIP_MAX_PIXELS (34) is
+ * the hard limit, checked at compile time.
+ */
+
+#ifndef LED_STRIP_H
+#define LED_STRIP_H
+
+#include <Arduino.h>
+#include "BuildProfile.h"
+
+#ifndef LED_STRIP_PIXELS
+#define LED_STRIP_PIXELS 30
+#endif
+
+#ifndef LED_STRIP_PIN
+#define LED_STRIP_PIN 7 // Free on the current board; the RGB pins stay unused
+#endif
+
+#define LED_STRIP_FRAME_MILLIS 33 // ~30 fps cap, ~3% CPU for 30 pixels
+
+#define LED_STRIP_PIXEL_MICROS 30 // 24 bits at 1.25us
+#define LED_STRIP_MAX_PIXELS 34   // 34 * 30us = 1020us, inside one Timer0 overflow period
+
+static_assert(LED_STRIP_PIXELS >= 1 && LED_STRIP_PIXELS <= LED_STRIP_MAX_PIXELS,
+              "LED_STRIP_PIXELS: a longer push masks interrupts across two Timer0 overflows");
+
+class LEDStrip {
+public:
+  // One pixel unless the strip backend is built, so PWM builds pay nothing
+  static const uint8_t PIXELS = BuildProfile::ledStrip ? LED_STRIP_PIXELS : 1;
+
+  // Interrupts-masked time of one push
+  static const uint16_t PUSH_MICROS = PIXELS * LED_STRIP_PIXEL_MICROS;
+
+private:
+  static uint8_t frame[PIXELS * 3]; // G, R, B per pixel - wire order
+  static volatile uint8_t* port;
+  static uint8_t pinMask;
+  static bool dirty;
+  static unsigned long lastPushMillis;
+
+  // Counters for STAT:
+  static uint16_t framesPushed;
+  static uint16_t framesDeferred;
+  static uint16_t rxOverruns;
+
+  static void push();
+
+public:
+  // Configure the data pin and clear the strip
+  static void begin(uint8_t dataPin);
+
+  // Every pixel the same color
+  static void fill(uint8_t red, uint8_t green, uint8_t blue);
+
+  // Rainbow chase: pixel i samples the palette at position + i * spacing
+  // (see paletteColor() in FixedPoint.h), dimmed by brightness
+  static void rainbowChase(const uint8_t (*palette)[3], uint8_t sizeLog2,
+                           uint16_t position, uint16_t spacing, uint8_t brightness);
+
+  // Ocean wave: two sine waves of a 64-entry PROGMEM table travelling in
+  // opposite directions, blue at full scale and cyan at 100/255
+  static void oceanWave(const uint8_t* sineTable, uint8_t blueIndex, uint8_t cyanIndex,
+                        uint8_t brightness);
+
+  // Push the framebuffer if it changed, the frame cap allows it, the IR
+  // receiver is idle and no serial byte has arrived for rxQuietMicros >=
+  // PUSH_MICROS (pass 0 while a command is partly received). Returns true
+  // if a frame went out.
+  static bool show(bool receiverIdle, unsigned long rxQuietMicros);
+
+  static uint16_t pushedCount() { return framesPushed; }
+  static uint16_t deferredCount() { return framesDeferred; }
+  static uint16_t overrunCount() { return rxOverruns; }
+};
+
+#endif
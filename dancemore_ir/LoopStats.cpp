@@ -0,0 +1,73 @@
+/*
+ * LoopStats.cpp - Stage timing implementation
+ */
+
+#include "LoopStats.h"
+
+const char STAT_NAME_LOOP[] PROGMEM = "loop";
+const char STAT_NAME_ANIMATION[] PROGMEM = "anim";
+const char STAT_NAME_DISPLAY[] PROGMEM = "disp";
+const char STAT_NAME_IR[] PROGMEM = "ir";
+
+const char* const STAT_NAMES[STAT_STAGE_COUNT] PROGMEM = {
+  STAT_NAME_LOOP,
+  STAT_NAME_ANIMATION,
+  STAT_NAME_DISPLAY,
+  STAT_NAME_IR
+};
+
+LoopStats::LoopStats() {
+  reset();
+}
+
+void LoopStats::record(uint8_t stage, unsigned long elapsedMicros) {
+  StageStats& s = stages[stage];
+  uint16_t elapsed = (elapsedMicros > 0xFFFF) ? 0xFFFF : elapsedMicros;
+
+  if (elapsed < s.minMicros) s.minMicros = elapsed;
+  if (elapsed > s.maxMicros) s.maxMicros = elapsed;
+  s.totalMicros += elapsed;
+  s.count++;
+
+  // log2 bucket by shifting - no divide
+  uint8_t bucket = 0;
+  uint16_t scaled = elapsed >> 4;
+  while (scaled > 0 && bucket < STAT_HISTOGRAM_BUCKETS - 1) {
+    scaled >>= 1;
+    bucket++;
+  }
+  if (s.histogram[bucket] < 0xFFFF) {
+    s.histogram[bucket]++;
+  }
+}
+
+void LoopStats::reset() {
+  memset(stages, 0, sizeof(stages));
+  for (uint8_t i = 0; i < STAT_STAGE_COUNT; i++) {
+    stages[i].minMicros = 0xFFFF;
+  }
+}
+
+// Format: STAT <stage> n=<count> min=<us> max=<us> mean=<us> h=<b0>,<b1>,...
+void LoopStats::print() {
+  for (uint8_t i = 0; i < STAT_STAGE_COUNT; i++) {
+    const StageStats& s = stages[i];
+
+    Serial.print(F("STAT "));
+    Serial.print((const __FlashStringHelper*)pgm_read_ptr(&STAT_NAMES[i]));
+    Serial.print(F(" n="));
+    Serial.print(s.count);
+    Serial.print(F(" min="));
+    Serial.print(s.count > 0 ? s.minMicros : 0);
+    Serial.print(F(" max="));
+    Serial.print(s.maxMicros);
+    Serial.print(F(" mean="));
+    Serial.print(s.count > 0 ? s.totalMicros / s.count : 0);
+    Serial.print(F(" h="));
+    for (uint8_t b = 0; b < STAT_HISTOGRAM_BUCKETS; b++) {
+      if (b > 0) Serial.print(',');
+      Serial.print(s.histogram[b]);
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * LoopStats.h - Lightweight micros()-based stage timing
+ *
+ * Each instrumented stage keeps min/max/mean and a log2 histogram in a
+ * fixed-size struct. A StatProbe placed at the top of a block records the
+ * elapsed time when it goes out of scope. Exposed via STAT: / STAT:RESET.
+ */
+
+#ifndef LOOP_STATS_H
+#define LOOP_STATS_H
+
+#include <Arduino.h>
+
+// Instrumented stages
+enum StatStage : uint8_t {
+  STAT_LOOP,            // One scheduler pass (work only, not idle time)
+  STAT_ANIMATION_UPDATE, // SceneEngine::update() - LED + display effects
+  STAT_DISPLAY_COMMAND, // DisplayController::processCommand()
+  STAT_IR_OUTPUT,       // IR event filter + format + queue
+  STAT_STAGE_COUNT
+};
+
+// Bucket n counts samples below 16us << n; the last bucket is open-ended
+#define STAT_HISTOGRAM_BUCKETS 8
+
+struct StageStats {
+  uint16_t minMicros;
+  uint16_t maxMicros;
+  uint32_t totalMicros;
+  uint32_t count;
+  uint16_t histogram[STAT_HISTOGRAM_BUCKETS];
+};
+
+class LoopStats {
+private:
+  StageStats stages[STAT_STAGE_COUNT];
+
+public:
+  // Constructor
+  LoopStats();
+
+  // Add one sample to a stage (saturates at 65535us)
+  void record(uint8_t stage, unsigned long elapsedMicros);
+
+  // Clear all stages (STAT:RESET)
+  void reset();
+
+  // Print one line per stage
+  void print();
+};
+
+// Scope probe: times from construction to destruction
+class StatProbe {
+private:
+  LoopStats& stats;
+  uint8_t stage;
+  unsigned long start;
+
+public:
+  StatProbe(LoopStats& stats, uint8_t stage) : stats(stats), stage(stage), start(micros()) {}
+  ~StatProbe() { stats.record(stage, micros() - start); }
+};
+
+#endif
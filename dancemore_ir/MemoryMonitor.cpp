@@ -0,0 +1,104 @@
+/*
+ * MemoryMonitor.cpp - Stack painting and headroom scan
+ */
+
+#include "MemoryMonitor.h"
+#include <avr/wdt.h>
+
+extern char __data_start;
+extern char __bss_end;
+extern char __heap_start;
+extern char* __brkval;
+
+char* MemoryMonitor::heapHighWater = 0;
+
+// Survives the C runtime's .bss clear - written before it runs
+static uint8_t savedResetFlags __attribute__((section(".noinit")));
+
+#if defined(__AVR__) // The native build under host/ has no init sections
+// .init1 runs before the stack is in use and before r1 is zeroed, so the
+// paint loop is plain assembly: fill _end .. RAMEND with the canary
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+  __asm__ volatile(
+    "    ldi r30, lo8(_end)\n"
+    "    ldi r31, hi8(_end)\n"
+    "    ldi r24, %0\n"
+    "    ldi r25, hi8(%1)\n"
+    "1:  st Z+, r24\n"
+    "    cpi r30, lo8(%1)\n"
+    "    cpc r31, r25\n"
+    "    brlo 1b\n"
+    "    breq 1b\n"
+    :
+    : "i"(MEMORY_CANARY), "i"(RAMEND)
+  );
+}
+
+// .init3: MCUSR must be read and cleared before the watchdog can fire
+// again. Optiboot clears MCUSR itself and hands the value over in r2.
+void saveResetFlags() __attribute__((naked, used, section(".init3")));
+void saveResetFlags() {
+  uint8_t flags = MCUSR;
+  if (flags == 0) {
+    __asm__ volatile("mov %0, r2" : "=r"(flags));
+  }
+  savedResetFlags = flags;
+  MCUSR = 0;
+  wdt_disable();
+}
+#endif
+
+// Start of the untouched region - above whatever the heap ever reached
+static char* heapTop() {
+  return (__brkval == 0) ? &__heap_start : __brkval;
+}
+
+uint16_t MemoryMonitor::freeRam() {
+  char stackMarker;
+  return (uint16_t)(&stackMarker - heapTop());
+}
+
+// Scan down from the stack: its dirty bytes come first, then the untouched
+// gap, then whatever the heap wrote. Starting from the heap side would
+// depend on heapHighWater, which can lag the real break by a loop pass and
+// start the scan on dirty heap bytes. The longest canary run is the gap -
+// a stray canary value in stack or heap data only makes a shorter one.
+uint16_t MemoryMonitor::minimumFreeRam() {
+  char stackMarker;
+  char* bottom = heapTop();
+  uint16_t run = 0;
+  uint16_t longest = 0;
+  for (char* p = &stackMarker - 1; p >= bottom; p--) {
+    if (*(uint8_t*)p == MEMORY_CANARY) {
+      if (++run > longest) {
+        longest = run;
+      }
+    } else {
+      run = 0;
+    }
+  }
+  return longest;
+}
+
+uint16_t MemoryMonitor::heapPeak() {
+  return (heapHighWater == 0) ? 0 : (uint16_t)(heapHighWater - &__heap_start);
+}
+
+uint16_t MemoryMonitor::staticRam() {
+  return (uint16_t)(&__bss_end - &__data_start);
+}
+
+uint8_t MemoryMonitor::resetCause() {
+  return savedResetFlags;
+}
+
+void MemoryMonitor::printResetCause() {
+  uint8_t flags = savedResetFlags;
+  if (flags & _BV(WDRF)) Serial.print(F(" watchdog"));
+  if (flags & _BV(BORF)) Serial.print(F(" brown-out"));
+  if (flags & _BV(EXTRF)) Serial.print(F(" external"));
+  if (flags & _BV(PORF)) Serial.print(F(" power-on"));
+  if (flags == 0) Serial.print(F(" unknown"));
+  Serial.println();
+}
@@ -0,0 +1,51 @@
+/*
+ * MemoryMonitor.h - Stack/heap headroom tracking and reset cause
+ *
+ * Before the C runtime starts, every byte between the end of .bss and the
+ * top of RAM is painted with a canary. Stack pushes and heap allocations
+ * overwrite it, so the canary bytes still intact above the heap are the
+ * RAM that has never been used since boot - the real worst-case headroom,
+ * not a freeRam() snapshot taken at a quiet moment.
+ *
+ * The reset cause (MCUSR) is captured in the same early init code, before
+ * anything else can clear it.
+ */
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+#define MEMORY_CANARY 0xC5
+
+class MemoryMonitor {
+private:
+  static char* heapHighWater;
+
+public:
+  // Track the highest heap break seen - cheap enough for every loop pass
+  static void sampleHeap() {
+    extern char* __brkval;
+    if (__brkval > heapHighWater) {
+      heapHighWater = __brkval;
+    }
+  }
+
+  // Bytes between the heap and the stack right now
+  static uint16_t freeRam();
+
+  // Bytes never touched by stack or heap since boot (canary scan)
+  static uint16_t minimumFreeRam();
+
+  // Peak heap size since boot
+  static uint16_t heapPeak();
+
+  // .data + .bss - every static allocation in the image
+  static uint16_t staticRam();
+
+  // MCUSR as it was at reset: PORF, EXTRF, BORF, WDRF bits
+  static uint8_t resetCause();
+  static void printResetCause();
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * PersistentConfig.cpp - EEPROM settings block implementation
+ */
+
+#include "PersistentConfig.h"
+#include <EEPROM.h>
+#include "BinaryProtocol.h"
+#include "CommandRegistry.h"
+#include "LEDAnimations.h"
+
+DeviceConfig PersistentConfig::current;
+
+// Header bytes before the payload: magic, version, length
+#define CONFIG_HEADER_SIZE 3
+
+static uint8_t configCrc(const DeviceConfig& config) {
+  const uint8_t* bytes = (const uint8_t*)&config;
+  uint8_t crc = crc8Update(0, CONFIG_VERSION);
+  crc = crc8Update(crc, sizeof(DeviceConfig));
+  for (uint8_t i = 0; i < sizeof(DeviceConfig); i++) {
+    crc = crc8Update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+// A block with a good CRC can still carry values this build doesn't know,
+// e.g. an animation number this build has no command for
+static bool isValid(const DeviceConfig& config) {
+  if (config.brightness > 7 || config.outputMode > CONFIG_OUTPUT_DEBUG) {
+    return false;
+  }
+  return config.defaultAnimation == CONFIG_NO_ANIMATION ||
+         LEDAnimations::animationName(config.defaultAnimation) != nullptr;
+}
+
+void PersistentConfig::setDefaults() {
+  current.brightness = 4;
+  current.defaultAnimation = CONFIG_NO_ANIMATION;
+  current.outputMode = CONFIG_OUTPUT_AUTO;
+  current.verbosity = 0;
+  current.flags = 0;
+}
+
+bool PersistentConfig::load() {
+  int address = CONFIG_EEPROM_ADDRESS;
+  if (EEPROM.read(address) != CONFIG_MAGIC ||
+      EEPROM.read(address + 1) != CONFIG_VERSION ||
+      EEPROM.read(address + 2) != sizeof(DeviceConfig)) {
+    setDefaults();
+    return false;
+  }
+
+  DeviceConfig stored;
+  EEPROM.get(address + CONFIG_HEADER_SIZE, stored);
+  if (EEPROM.read(address + CONFIG_HEADER_SIZE + sizeof(DeviceConfig)) != configCrc(stored) ||
+      !isValid(stored)) {
+    setDefaults();
+    return false;
+  }
+
+  current = stored;
+  return true;
+}
+
+void PersistentConfig::save() {
+  int address = CONFIG_EEPROM_ADDRESS;
+  EEPROM.update(address, CONFIG_MAGIC);
+  EEPROM.update(address + 1, CONFIG_VERSION);
+  EEPROM.update(address + 2, sizeof(DeviceConfig));
+
+  const uint8_t* bytes = (const uint8_t*)&current;
+  for (uint8_t i = 0; i < sizeof(DeviceConfig); i++) {
+    EEPROM.update(address + CONFIG_HEADER_SIZE + i, bytes[i]);
+  }
+  EEPROM.update(address + CONFIG_HEADER_SIZE + sizeof(DeviceConfig), configCrc(current));
+}
+
+// CFG:                   print settings
+// CFG:BRT:n              display brightness 0-7
+// CFG:ANIM:name|none     LED animation looped from boot
+// CFG:OUT:auto|flipper|debug
+// CFG:VERB:n             bit 0 = repeats, bit 1 = raw data
+// CFG:FAST:0|1           fast boot
+// CFG:SAVE / CFG:RESET   persist / restore defaults (and persist)
+bool PersistentConfig::processCommand(char* args) {
+  char* cursor = args;
+  char* key = nextToken(cursor, ':');
+  char* value = cursor;
+
+  if (*key == '\0') {
+    print();
+    return true;
+  }
+
+  if (strcasecmp_P(key, PSTR("SAVE")) == 0) {
+    save();
+  } else if (strcasecmp_P(key, PSTR("RESET")) == 0) {
+    setDefaults();
+    save();
+  } else if (strcasecmp_P(key, PSTR("BRT")) == 0) {
+    int brightness = atoi(value);
+    if (brightness < 0 || brightness > 7 || *value == '\0') return false;
+    current.brightness = brightness;
+  } else if (strcasecmp_P(key, PSTR("ANIM")) == 0) {
+    if (strcasecmp_P(value, PSTR("none")) == 0 || strcasecmp_P(value, PSTR("off")) == 0) {
+      current.defaultAnimation = CONFIG_NO_ANIMATION;
+    } else {
+      int animation = LEDAnimations::animationForName(value);
+      if (animation < 0) return false;
+      current.defaultAnimation = animation;
+    }
+  } else if (strcasecmp_P(key, PSTR("OUT")) == 0) {
+    if (strcasecmp_P(value, PSTR("auto")) == 0) {
+      current.outputMode = CONFIG_OUTPUT_AUTO;
+    } else if (strcasecmp_P(value, PSTR("flipper")) == 0) {
+      current.outputMode = CONFIG_OUTPUT_FLIPPER;
+    } else if (strcasecmp_P(value, PSTR("debug")) == 0) {
+      current.outputMode = CONFIG_OUTPUT_DEBUG;
+    } else {
+      return false;
+    }
+  } else if (strcasecmp_P(key, PSTR("VERB")) == 0) {
+    current.verbosity = atoi(value) & (CONFIG_VERBOSE_REPEATS | CONFIG_VERBOSE_RAW);
+  } else if (strcasecmp_P(key, PSTR("FAST")) == 0) {
+    if (atoi(value) != 0) {
+      current.flags |= CONFIG_FLAG_FAST_BOOT;
+    } else {
+      current.flags &= ~CONFIG_FLAG_FAST_BOOT;
+    }
+  } else {
+    return false;
+  }
+
+  print();
+  return true;
+}
+
+void PersistentConfig::print() {
+  Serial.print(F("CFG brt="));
+  Serial.print(current.brightness);
+  Serial.print(F(" anim="));
+  const __FlashStringHelper* name = LEDAnimations::animationName(current.defaultAnimation);
+  if (name != nullptr) {
+    Serial.print(name);
+  } else {
+    Serial.print(F("none"));
+  }
+  Serial.print(F(" out="));
+  switch (current.outputMode) {
+    case CONFIG_OUTPUT_FLIPPER: Serial.print(F("flipper")); break;
+    case CONFIG_OUTPUT_DEBUG: Serial.print(F("debug")); break;
+    default: Serial.print(F("auto")); break;
+  }
+  Serial.print(F(" verb="));
+  Serial.print(current.verbosity);
+  Serial.print(F(" fast="));
+  Serial.println(fastBoot() ? 1 : 0);
+}
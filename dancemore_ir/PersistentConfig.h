@@ -0,0 +1,64 @@
+/*
+ * PersistentConfig.h - Versioned, CRC-checked settings block in EEPROM
+ *
+ * Layout at EEPROM address CONFIG_EEPROM_ADDRESS:
+ *   magic | version | payload length | DeviceConfig payload | crc8
+ * The CRC (crc8Update, shared with the binary frame protocol) covers
+ * version, length and payload. A missing, corrupt or older block, or one
+ * with an out-of-range field, loads the defaults instead.
+ *
+ * CFG: commands edit the live copy; CFG:SAVE writes it back. EEPROM.update
+ * only rewrites bytes that changed, so repeated saves don't wear the cells.
+ */
+
+#ifndef PERSISTENT_CONFIG_H
+#define PERSISTENT_CONFIG_H
+
+#include <Arduino.h>
+
+#define CONFIG_EEPROM_ADDRESS 0
+#define CONFIG_MAGIC 0xDC
+#define CONFIG_VERSION 1
+
+// DeviceConfig::outputMode
+#define CONFIG_OUTPUT_AUTO    0 // Debug jumper on pin 10 decides
+#define CONFIG_OUTPUT_FLIPPER 1 // Flipper-compatible lines regardless of jumper
+#define CONFIG_OUTPUT_DEBUG   2 // Detailed debug output regardless of jumper
+
+// DeviceConfig::verbosity bits (debug output only)
+#define CONFIG_VERBOSE_REPEATS 0x01 // Print hold summaries for repeat frames
+#define CONFIG_VERBOSE_RAW     0x02 // Print raw timing data
+
+// DeviceConfig::flags
+#define CONFIG_FLAG_FAST_BOOT 0x01 // Skip the startup pattern and boot delays
+
+#define CONFIG_NO_ANIMATION 0xFF // DeviceConfig::defaultAnimation: none
+
+struct DeviceConfig {
+  uint8_t brightness;       // Display brightness 0-7
+  uint8_t defaultAnimation; // AnimationMode looped from boot, or CONFIG_NO_ANIMATION
+  uint8_t outputMode;       // CONFIG_OUTPUT_*
+  uint8_t verbosity;        // CONFIG_VERBOSE_* bits
+  uint8_t flags;            // CONFIG_FLAG_* bits
+};
+
+class PersistentConfig {
+public:
+  static DeviceConfig current;
+
+  // Defaults match the behavior before the config block existed
+  static void setDefaults();
+
+  // Read the EEPROM block into `current` - false (and defaults) if invalid
+  static bool load();
+  static void save();
+
+  static bool fastBoot() { return current.flags & CONFIG_FLAG_FAST_BOOT; }
+
+  // Command processing (text after the "CFG:" prefix). Changes apply to
+  // `current` only; the sketch applies whichever keys a command changed.
+  static bool processCommand(char* args);
+  static void print();
+};
+
+#endif
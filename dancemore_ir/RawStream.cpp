@@ -0,0 +1,182 @@
+/*
+ * RawStream.cpp - Raw IR timing stream implementation
+ */
+
+#include "RawStream.h"
+#include "BinaryProtocol.h"
+
+#define RAW_NO_BUFFER 0xFF
+#define RAW_REPEAT_RESERVE 3 // Largest repeat token, kept free for the final flush
+
+RawStream::RawStream()
+  : filling(RAW_NO_BUFFER), nextDrain(0), payload(nullptr), payloadLength(0),
+    durationCount(0), flags(0), pendingMark(0), havePendingMark(false), havePair(false),
+    pairMark(0), pairSpace(0), pairRepeats(0), mode(RAW_MODE_OFF), sequence(0),
+    droppedBursts(0) {
+  burstLength[0] = 0;
+  burstLength[1] = 0;
+  previous[0] = 0;
+  previous[1] = 0;
+}
+
+bool RawStream::beginBurst(uint8_t usPerTick, uint8_t burstFlags) {
+  if (burstLength[0] == 0) {
+    filling = 0;
+  } else if (burstLength[1] == 0) {
+    filling = 1;
+  } else {
+    droppedBursts++;
+    filling = RAW_NO_BUFFER;
+    return false;
+  }
+
+  uint8_t* burst = bursts[filling];
+  burst[0] = RAW_SYNC;
+  burst[1] = sequence++;
+  burst[3] = usPerTick;
+  payload = burst + RAW_HEADER_SIZE;
+  payloadLength = 0;
+  durationCount = 0;
+  flags = burstFlags;
+  previous[0] = 0;
+  previous[1] = 0;
+  havePendingMark = false;
+  havePair = false;
+  pairRepeats = 0;
+  return true;
+}
+
+static uint8_t varintSize(uint16_t value) {
+  return (value < 0x80) ? 1 : (value < 0x4000) ? 2 : 3;
+}
+
+// Tokens are never split: one that doesn't fit in full, leaving `reserve`
+// bytes free, truncates the burst instead
+bool RawStream::putVarint(uint16_t value, uint8_t reserve) {
+  if (payloadLength + varintSize(value) + reserve > RAW_PAYLOAD_MAX) {
+    flags |= RAW_FLAG_TRUNCATED;
+    return false;
+  }
+  while (value >= 0x80) {
+    payload[payloadLength++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  payload[payloadLength++] = value;
+  return true;
+}
+
+bool RawStream::putLiteral(uint8_t polarity, uint16_t duration, uint8_t reserve) {
+  int16_t delta = (int16_t)(duration - previous[polarity]);
+  uint16_t zigzag = (delta >= 0) ? ((uint16_t)delta << 1) : (((uint16_t)~delta << 1) | 1);
+  if (!putVarint(zigzag << 1, reserve)) { // Low bit 0 = literal
+    return false;
+  }
+  previous[polarity] = duration;
+  return true;
+}
+
+// Always fits: every literal pair leaves RAW_REPEAT_RESERVE bytes for it
+void RawStream::flushRepeats() {
+  if (pairRepeats > 0) {
+    putVarint((pairRepeats << 1) | 1, 0);
+    pairRepeats = 0;
+  }
+}
+
+bool RawStream::addPair(uint16_t mark, uint16_t space) {
+  if (havePair && mark == pairMark && space == pairSpace && pairRepeats < 0x3FFF) {
+    pairRepeats++;
+    return true;
+  }
+  flushRepeats();
+
+  // Both literals or neither, so durationCount matches the payload
+  uint8_t rollback = payloadLength;
+  uint16_t previousMark = previous[0];
+  if (!putLiteral(0, mark, RAW_REPEAT_RESERVE) ||
+      !putLiteral(1, space, RAW_REPEAT_RESERVE)) {
+    payloadLength = rollback;
+    previous[0] = previousMark;
+    return false;
+  }
+  pairMark = mark;
+  pairSpace = space;
+  havePair = true;
+  return true;
+}
+
+void RawStream::addDuration(uint16_t ticks) {
+  if (filling == RAW_NO_BUFFER || (flags & RAW_FLAG_TRUNCATED)) {
+    return;
+  }
+
+  if (!havePendingMark) {
+    pendingMark = ticks;
+    havePendingMark = true;
+    return;
+  }
+  havePendingMark = false;
+  if (durationCount > 0xFF - 2) {
+    flags |= RAW_FLAG_TRUNCATED; // Header count is one byte
+    return;
+  }
+  if (addPair(pendingMark, ticks)) {
+    durationCount += 2;
+  }
+}
+
+void RawStream::endBurst() {
+  if (filling == RAW_NO_BUFFER) {
+    return;
+  }
+
+  flushRepeats();
+  // Trailing mark has no space after it - it may use the repeat reserve
+  if (havePendingMark && !(flags & RAW_FLAG_TRUNCATED) && durationCount < 0xFF &&
+      putLiteral(0, pendingMark, 0)) {
+    durationCount++;
+  }
+
+  uint8_t* burst = bursts[filling];
+  burst[2] = flags;
+  burst[4] = durationCount;
+  burst[5] = payloadLength;
+
+  uint8_t crc = 0;
+  for (uint8_t i = 1; i < RAW_HEADER_SIZE + payloadLength; i++) {
+    crc = crc8Update(crc, burst[i]);
+  }
+  burst[RAW_HEADER_SIZE + payloadLength] = crc;
+
+  // The other buffer, if full, is older and drains first
+  if (burstLength[filling ^ 1] == 0) {
+    nextDrain = filling;
+  }
+  burstLength[filling] = RAW_HEADER_SIZE + payloadLength + 1;
+  filling = RAW_NO_BUFFER;
+}
+
+void RawStream::pump(TxRing& ring) {
+  uint8_t length = burstLength[nextDrain];
+  if (length == 0 || length > ring.freeSpace()) {
+    return; // Wait for the UART rather than drop a burst
+  }
+
+  ring.enqueue((const char*)bursts[nextDrain], length);
+  burstLength[nextDrain] = 0;
+  nextDrain ^= 1;
+}
+
+// RAW:ON (UNKNOWN frames), RAW:ALL (every frame), RAW:OFF
+bool RawStream::processCommand(char* args) {
+  if (strcasecmp_P(args, PSTR("ON")) == 0) {
+    mode = RAW_MODE_UNKNOWN;
+  } else if (strcasecmp_P(args, PSTR("ALL")) == 0) {
+    mode = RAW_MODE_ALL;
+  } else if (strcasecmp_P(args, PSTR("OFF")) == 0) {
+    mode = RAW_MODE_OFF;
+  } else {
+    return false;
+  }
+  return true;
+}
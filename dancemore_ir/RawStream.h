@@ -0,0 +1,95 @@
+/*
+ * RawStream.h - Compact binary streaming of raw IR mark/space timings
+ *
+ * RAW:ON streams the IRremote timing buffer of every UNKNOWN frame
+ * (RAW:ALL: every frame) as a binary burst instead of ASCII, which loses
+ * bursts at 115200 baud. Durations stay in receiver ticks (usPerTick in
+ * the header) and are encoded as tokens, each one LEB128 varint:
+ *
+ *   literal: zigzag(duration - previous duration of the same polarity) << 1
+ *   repeat:  (n << 1) | 1 - the previous mark/space pair occurs n more times
+ *
+ * Burst: 0xA6 | seq | flags | usPerTick | durations | payload len | payload | crc8
+ * (crc8Update over seq..payload). Durations alternate mark, space, mark...
+ * starting with a mark; the leading gap is not sent. The durations count
+ * only covers tokens that made it into the payload, even when truncated.
+ *
+ * Two burst buffers: one is encoded from the capture while the other waits
+ * for TX ring space, so capture keeps going during a slow drain.
+ */
+
+#ifndef RAW_STREAM_H
+#define RAW_STREAM_H
+
+#include <Arduino.h>
+#include "SerialOutput.h"
+
+#define RAW_SYNC 0xA6
+#define RAW_HEADER_SIZE 6
+#define RAW_PAYLOAD_MAX 80
+#define RAW_BURST_MAX (RAW_HEADER_SIZE + RAW_PAYLOAD_MAX + 1)
+
+// Burst flags
+#define RAW_FLAG_TRUNCATED 0x01 // Payload full - later durations dropped
+#define RAW_FLAG_REPEAT    0x02 // IRremote flagged the frame as a repeat
+
+// Streaming modes
+#define RAW_MODE_OFF     0
+#define RAW_MODE_UNKNOWN 1 // RAW:ON
+#define RAW_MODE_ALL     2 // RAW:ALL
+
+class RawStream {
+private:
+  uint8_t bursts[2][RAW_BURST_MAX];
+  uint8_t burstLength[2]; // 0 = free
+  uint8_t filling;        // Buffer being encoded, or 0xFF
+  uint8_t nextDrain;      // Older of two full buffers
+
+  // Encoder state for the burst being filled
+  uint8_t* payload;
+  uint8_t payloadLength;
+  uint8_t durationCount;
+  uint8_t flags;
+  uint16_t previous[2];   // Last mark / space duration (ticks)
+  uint16_t pendingMark;
+  bool havePendingMark;
+  bool havePair;
+  uint16_t pairMark, pairSpace;
+  uint16_t pairRepeats;
+
+  uint8_t mode;
+  uint8_t sequence;
+  uint16_t droppedBursts;
+
+  bool putVarint(uint16_t value, uint8_t reserve);
+  bool putLiteral(uint8_t polarity, uint16_t duration, uint8_t reserve);
+  void flushRepeats();
+  bool addPair(uint16_t mark, uint16_t space);
+
+public:
+  RawStream();
+
+  // Should a decoded frame of this protocol be streamed?
+  bool wants(bool isUnknown) const {
+    return mode == RAW_MODE_ALL || (mode == RAW_MODE_UNKNOWN && isUnknown);
+  }
+
+  // Encode one capture: beginBurst, addDuration per mark/space, endBurst.
+  // beginBurst returns false (and counts a drop) if neither buffer is free.
+  bool beginBurst(uint8_t usPerTick, uint8_t burstFlags);
+  void addDuration(uint16_t ticks);
+  void endBurst();
+
+  // Queue the oldest finished burst into the TX ring once it fits
+  void pump(TxRing& ring);
+
+  // A finished burst is still waiting for the TX ring
+  bool isPending() const { return burstLength[0] != 0 || burstLength[1] != 0; }
+
+  uint16_t droppedCount() const { return droppedBursts; }
+
+  // Command processing (text after the "RAW:" prefix)
+  bool processCommand(char* args);
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * SceneEngine.cpp - Synchronized LED + display scenes implementation
+ */
+
+#include "SceneEngine.h"
+#include "BuildProfile.h"
+
+// Display intervals divide the LED interval so both step on the same ticks
+const Scene sceneTable[] PROGMEM = {
+  {"busy", ANIM_THINKING, DISP_ANIM_SPINNER, 100},  // LED keyframes 200ms: 2 spinner frames each, 6 per color
+  {"alert", ANIM_RED_BLUE, DISP_ANIM_DOTS, 150},    // Dot moves with every red/blue flip
+  {"party", ANIM_RAINBOW, DISP_ANIM_ROTATE, 100},   // LED 50ms
+  {"scan", ANIM_OCEAN, DISP_ANIM_WAVE, 80}          // LED 40ms
+};
+
+const uint8_t NUM_SCENES = sizeof(sceneTable) / sizeof(sceneTable[0]);
+
+SceneEngine::SceneEngine(LEDAnimations& leds, DisplayAnimations& displayAnimations,
+                         DisplayController& display)
+  : leds(leds), displayAnimations(displayAnimations), display(display),
+    tickMillis(0), sceneEndTime(0), activeScene(SCENE_NONE), debugMode(false) {
+}
+
+void SceneEngine::begin(bool debugMode) {
+  this->debugMode = debugMode;
+  tickMillis = millis();
+}
+
+void SceneEngine::update() {
+  tickMillis = millis();
+
+  if (activeScene != SCENE_NONE && sceneEndTime > 0 &&
+      (long)(tickMillis - sceneEndTime) >= 0) {
+    stop();
+  }
+
+  leds.update(tickMillis);
+  displayAnimations.update(tickMillis);
+  display.updateScroll(tickMillis);
+}
+
+void SceneEngine::start(uint8_t index, uint16_t durationSeconds) {
+  if (index >= NUM_SCENES) {
+    return;
+  }
+
+  tickMillis = millis();
+  activeScene = index;
+  sceneEndTime = (durationSeconds > 0) ? tickMillis + durationSeconds * 1000UL : 0;
+
+  // Both effects run open-ended; the scene ends them together
+  uint16_t displayInterval = pgm_read_word(&sceneTable[index].displayIntervalMillis);
+  displayAnimations.start((DisplayAnimationMode)pgm_read_byte(&sceneTable[index].displayMode),
+                          0, tickMillis);
+  if (displayInterval > 0) {
+    displayAnimations.setInterval(displayInterval);
+  }
+  leds.startAnimation(pgm_read_byte(&sceneTable[index].ledMode), 0);
+  leds.update(tickMillis); // First LED step on the same tick as the first display frame
+}
+
+void SceneEngine::stop() {
+  activeScene = SCENE_NONE;
+  sceneEndTime = 0;
+  leds.off();
+  displayAnimations.start(DISP_ANIM_OFF, 0, tickMillis);
+}
+
+// SCENE:<name> [seconds] - SCENE:off stops both effects
+bool SceneEngine::processCommand(char* args) {
+  char* cursor = args;
+  char* name = nextToken(cursor, ' ');
+  uint16_t duration = atoi(cursor);
+
+  if (strcasecmp_P(name, PSTR("off")) == 0) {
+    stop();
+    return true;
+  }
+
+  for (uint8_t i = 0; i < NUM_SCENES; i++) {
+    if (strcasecmp_P(name, sceneTable[i].name) == 0) {
+      start(i, duration);
+      if (BuildProfile::debug(debugMode)) {
+        Serial.print(F("Scene started: "));
+        Serial.println(name);
+      }
+      return true;
+    }
+  }
+
+  if (BuildProfile::debug(debugMode)) {
+    printHelp();
+  }
+  return true;
+}
+
+void SceneEngine::printHelp() {
+  Serial.println(F("Scenes:"));
+  for (uint8_t i = 0; i < NUM_SCENES; i++) {
+    Serial.print(F("  SCENE:"));
+    Serial.print((const __FlashStringHelper*)sceneTable[i].name);
+    Serial.println(F(" [seconds]"));
+  }
+  Serial.println(F("  SCENE:off"));
+}
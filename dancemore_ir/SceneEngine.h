@@ -0,0 +1,68 @@
+/*
+ * SceneEngine.h - Synchronized LED + display scenes on one timebase
+ *
+ * Owns the animation clock: update() reads millis() once per tick and
+ * hands the same timestamp to LEDAnimations, DisplayAnimations and the
+ * display marquee, so effects started together stay frame-locked instead
+ * of each subsystem sampling the clock on its own.
+ *
+ * A scene pairs an LED effect with a display effect whose step interval
+ * is a harmonic of the LED interval. SCENE:<name> [seconds] starts both on
+ * the same tick; SCENE:off stops both.
+ */
+
+#ifndef SCENE_ENGINE_H
+#define SCENE_ENGINE_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "LEDAnimations.h"
+#include "DisplayAnimations.h"
+
+#define SCENE_NAME_MAX 8 // Longest name + terminator
+#define SCENE_NONE 0xFF
+
+// Scene table entry - lives in PROGMEM
+struct Scene {
+  char name[SCENE_NAME_MAX];
+  uint8_t ledMode;               // AnimationMode
+  uint8_t displayMode;           // DisplayAnimationMode
+  uint16_t displayIntervalMillis; // Locked to the LED interval (0 = effect default)
+};
+
+class SceneEngine {
+private:
+  LEDAnimations& leds;
+  DisplayAnimations& displayAnimations;
+  DisplayController& display;
+
+  unsigned long tickMillis;   // Timestamp shared by every effect this tick
+  unsigned long sceneEndTime; // 0 = run until stopped
+  uint8_t activeScene;        // Index into the scene table, or SCENE_NONE
+  bool debugMode;
+
+public:
+  SceneEngine(LEDAnimations& leds, DisplayAnimations& displayAnimations,
+              DisplayController& display);
+
+  void begin(bool debugMode = false);
+
+  // One clock read, then advance every effect against it
+  void update();
+
+  // Start scene `index` on the current tick (durationSeconds 0 = loop)
+  void start(uint8_t index, uint16_t durationSeconds);
+  void stop();
+
+  // Forget the running scene without touching the outputs - called when
+  // a direct LED:/DISP: command takes over one of them
+  void release() { activeScene = SCENE_NONE; }
+
+  unsigned long now() const { return tickMillis; }
+
+  // Command processing (text after the "SCENE:" prefix, tokenized in place)
+  bool processCommand(char* args);
+  void printHelp();
+};
+
+#endif
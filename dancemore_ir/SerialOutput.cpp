@@ -0,0 +1,118 @@
+/*
+ * SerialOutput.cpp - Non-blocking serial output implementation
+ */
+
+#include "SerialOutput.h"
+
+static const char HEX_DIGITS[] PROGMEM = "0123456789ABCDEF";
+
+LineBuffer::LineBuffer() {
+  clear();
+}
+
+void LineBuffer::clear() {
+  length = 0;
+  truncated = false;
+}
+
+void LineBuffer::append(char c) {
+  if (length < LINE_TEXT_MAX) {
+    text[length++] = c;
+  } else {
+    truncated = true;
+  }
+}
+
+void LineBuffer::append(const char* str) {
+  while (*str != '\0') {
+    append(*str++);
+  }
+}
+
+void LineBuffer::append(const __FlashStringHelper* str) {
+  const char* p = (const char*)str;
+  char c;
+  while ((c = pgm_read_byte(p++)) != '\0') {
+    append(c);
+  }
+}
+
+void LineBuffer::appendHex(uint32_t value, uint8_t minDigits) {
+  // Find the highest non-zero nibble, then emit nibbles straight from the table
+  uint8_t digits = 8;
+  while (digits > 1 && ((value >> ((digits - 1) * 4)) & 0x0F) == 0) {
+    digits--;
+  }
+  if (digits < minDigits) {
+    digits = minDigits;
+  }
+
+  while (digits > 0) {
+    digits--;
+    append((char)pgm_read_byte(&HEX_DIGITS[(value >> (digits * 4)) & 0x0F]));
+  }
+}
+
+void LineBuffer::appendDecimal(uint32_t value) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  while (n > 0) {
+    append(digits[--n]);
+  }
+}
+
+void LineBuffer::appendNewline() {
+  // Text stops at LINE_TEXT_MAX, so the terminator always fits once
+  if (length > LINE_TEXT_MAX) {
+    truncated = true;
+    return;
+  }
+  text[length++] = '\r';
+  text[length++] = '\n';
+}
+
+TxRing::TxRing() : head(0), tail(0), droppedLines(0), bytesQueued(0) {
+}
+
+bool TxRing::enqueue(const char* data, uint8_t length) {
+  if (length > freeSpace()) {
+    droppedLines++;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    buffer[head] = data[i];
+    head = (head + 1) & (TX_RING_SIZE - 1);
+  }
+  bytesQueued += length;
+  return true;
+}
+
+bool TxRing::reserve(uint8_t length) {
+  if (length > freeSpace()) {
+    droppedLines++;
+    return false;
+  }
+  return true;
+}
+
+void TxRing::drain() {
+  while (tail != head) {
+    Serial.write(buffer[tail]); // Waits for UART buffer space
+    tail = (tail + 1) & (TX_RING_SIZE - 1);
+  }
+}
+
+void TxRing::pump() {
+  int room = Serial.availableForWrite();
+  while (room > 0 && tail != head) {
+    Serial.write(buffer[tail]);
+    tail = (tail + 1) & (TX_RING_SIZE - 1);
+    room--;
+  }
+}
@@ -0,0 +1,88 @@
+/*
+ * SerialOutput.h - Non-blocking serial output for IR events
+ *
+ * LineBuffer renders a whole output line into a preallocated buffer
+ * (table-driven hex, no Serial.print chains). TxRing queues finished lines
+ * and pump() hands bytes to the hardware UART only as fast as its buffer
+ * has room, so formatting an event never blocks the main loop. When the
+ * ring is full the line is dropped and counted instead.
+ *
+ * pump() may stop part way through a line, so code that still writes to
+ * Serial directly (command replies, frame ACKs) drains the ring first.
+ */
+
+#ifndef SERIAL_OUTPUT_H
+#define SERIAL_OUTPUT_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+#define LINE_BUFFER_SIZE 80
+#define LINE_TEXT_MAX (LINE_BUFFER_SIZE - 2) // Last two bytes are kept for "\r\n"
+#define TX_RING_SIZE 128 // Power of 2 - indices wrap with a mask
+
+class LineBuffer {
+private:
+  char text[LINE_BUFFER_SIZE];
+  uint8_t length;
+  bool truncated;
+
+public:
+  // Constructor
+  LineBuffer();
+
+  void clear();
+  void append(char c);
+  void append(const char* str);
+  void append(const __FlashStringHelper* str);
+  void appendHex(uint32_t value, uint8_t minDigits = 2); // Zero-padded, uppercase
+  void appendDecimal(uint32_t value);
+  void appendNewline(); // "\r\n" like Serial.println() - fits even after truncation
+
+  const char* data() const { return text; }
+  uint8_t size() const { return length; }
+  bool isTruncated() const { return truncated; }
+};
+
+class TxRing {
+private:
+  uint8_t buffer[TX_RING_SIZE];
+  uint8_t head; // Next write position
+  uint8_t tail; // Next byte to send
+  uint16_t droppedLines;
+  uint32_t bytesQueued;
+
+public:
+  // Constructor
+  TxRing();
+
+  // Queue a whole line - all or nothing. Returns false (and counts a drop)
+  // if it doesn't fit.
+  bool enqueue(const char* data, uint8_t length);
+  bool enqueue(const LineBuffer& line) { return enqueue(line.data(), line.size()); }
+
+  // Multi-line records written in place: reserve() checks for `length`
+  // bytes up front (false and a counted drop if they don't fit), then
+  // exactly that many put() calls follow
+  bool reserve(uint8_t length);
+  void put(char c) {
+    buffer[head] = c;
+    head = (head + 1) & (TX_RING_SIZE - 1);
+    bytesQueued++;
+  }
+
+  // Move queued bytes into the UART without blocking - call from a task
+  void pump();
+
+  // Blocking: send everything queued. Call before writing to Serial
+  // directly, so the direct bytes can't land inside a queued line or burst.
+  void drain();
+
+  uint8_t freeSpace() const { return (TX_RING_SIZE - 1) - (uint8_t)((head - tail) & (TX_RING_SIZE - 1)); }
+  bool isEmpty() const { return head == tail; }
+  void countDrop() { droppedLines++; } // Output discarded before reaching the ring
+  uint16_t droppedCount() const { return droppedLines; }
+  uint32_t queuedByteCount() const { return bytesQueued; }
+};
+
+#endif
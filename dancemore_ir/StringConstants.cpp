@@ -0,0 +1,104 @@
+/*
+ * StringConstants.cpp - The one definition of every pooled string
+ */
+
+#include "StringConstants.h"
+
+#define STRING_POOL_DEFINE(name, text) const char name[] PROGMEM = text;
+STRING_POOL(STRING_POOL_DEFINE)
+#undef STRING_POOL_DEFINE
+
+#define STRING_POOL_SIZE(name, text) + sizeof(text)
+const uint16_t STRING_POOL_BYTES = 0 STRING_POOL(STRING_POOL_SIZE);
+#undef STRING_POOL_SIZE
+
+// Help system arrays
+static const CommandHelp DISPLAY_COMMANDS[] PROGMEM = {
+    {HELP_DISP_TEXT, nullptr, true},
+    {HELP_DISP_SCROLL, nullptr, true},
+    {HELP_DISP_ANIM, nullptr, true},
+    {HELP_DISP_NUM, nullptr, true},
+    {HELP_DISP_CLR, nullptr, true},
+    {HELP_DISP_BRT, nullptr, true},
+    {HELP_DISP_ON, nullptr, true},
+    {HELP_DISP_OFF, nullptr, true}
+};
+
+static const CommandHelp LED_COMMANDS[] PROGMEM = {
+    {HELP_LED_ACK, nullptr, true},
+    {HELP_LED_NACK, nullptr, false},
+    {HELP_LED_POLICE, nullptr, true},
+    {HELP_LED_TRAFFIC, nullptr, true},
+    {HELP_LED_MATRIX, nullptr, true},
+    {HELP_LED_RAINBOW, nullptr, true},
+    {HELP_LED_PULSE_RED, nullptr, true},
+    {HELP_LED_PULSE_BLUE, nullptr, true},
+    {HELP_LED_STROBE, nullptr, true},
+    {HELP_LED_FIRE, nullptr, true},
+    {HELP_LED_OCEAN, nullptr, true},
+    {HELP_LED_THINKING, nullptr, true},
+    {HELP_LED_CUSTOM, nullptr, true},
+    {HELP_LED_KEY_ADD, nullptr, true},
+    {HELP_LED_KEY_CLEAR, nullptr, false},
+    {HELP_LED_OFF, nullptr, true}
+};
+
+constexpr int DISPLAY_COMMANDS_COUNT = sizeof(DISPLAY_COMMANDS) / sizeof(CommandHelp);
+constexpr int LED_COMMANDS_COUNT = sizeof(LED_COMMANDS) / sizeof(CommandHelp);
+
+// Print the entries of a PROGMEM help table, one per line
+static void printHelpTable(const CommandHelp* table, int count, bool all) {
+    for (int i = 0; i < count; i++) {
+        CommandHelp cmd;
+        memcpy_P(&cmd, &table[i], sizeof(CommandHelp));
+
+        if (all || cmd.showInBasicHelp) {
+            Serial.print(F("  "));
+            Serial.println(StringManager::flash(cmd.command));
+        }
+    }
+}
+
+void StringManager::printDisplayHelp(bool all) {
+    printHelpTable(DISPLAY_COMMANDS, DISPLAY_COMMANDS_COUNT, all);
+}
+
+void StringManager::printLEDHelp(bool all) {
+    printHelpTable(LED_COMMANDS, LED_COMMANDS_COUNT, all);
+}
+
+void StringManager::printDebugBanner(bool showRepeats, bool showRawData, unsigned long baudRate) {
+    Serial.println(flash(DEBUG_BANNER));
+    Serial.println(flash(DEBUG_CONFIG));
+    Serial.println(flash(DEBUG_JUMPER_INSTALLED));
+    Serial.println(flash(DEBUG_MODE_ON));
+    Serial.print(flash(DEBUG_SHOW_REPEATS));
+    Serial.println(flash(showRepeats ? STR_ON : STR_OFF));
+    Serial.print(flash(DEBUG_SHOW_RAW));
+    Serial.println(flash(showRawData ? STR_ON : STR_OFF));
+    Serial.print(flash(DEBUG_BAUD_RATE));
+    Serial.println(baudRate);
+    Serial.println(flash(DEBUG_DISPLAY_TYPE));
+    Serial.println(flash(DEBUG_LED_TYPE));
+}
+
+void StringManager::printDebugHelp() {
+    Serial.println();
+    Serial.println(flash(HELP_DISP_TITLE));
+    printDisplayHelp();
+    Serial.println();
+    Serial.println(flash(HELP_LED_TITLE));
+    printLEDHelp();
+    Serial.println();
+    Serial.println(flash(DEBUG_REMOVE_JUMPER));
+    Serial.println(flash(DEBUG_WAITING));
+    Serial.println(flash(DEBUG_FORMAT_HEADER));
+    Serial.println(flash(DEBUG_SEPARATOR));
+}
+
+void StringManager::printProductionBanner() {
+    Serial.println(flash(MSG_IR_RX));
+    Serial.println(flash(MSG_RECEIVING));
+    Serial.println(flash(MSG_PRESS_CTRL_C));
+}
+
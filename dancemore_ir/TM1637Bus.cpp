@@ -0,0 +1,138 @@
+/*
+ * TM1637Bus.cpp - Non-blocking TM1637 transfer engine implementation
+ */
+
+#include "TM1637Bus.h"
+
+TM1637Bus::TM1637Bus(uint8_t clkPin, uint8_t dioPin)
+  : clkPin(clkPin), dioPin(dioPin), queueLength(0), queuePos(0),
+    frameRemaining(0), currentByte(0), bitIndex(0), phase(PHASE_IDLE) {
+}
+
+void TM1637Bus::begin() {
+  // Released lines idle high; OUTPUT mode then pulls them low
+  pinMode(clkPin, INPUT);
+  pinMode(dioPin, INPUT);
+  digitalWrite(clkPin, LOW);
+  digitalWrite(dioPin, LOW);
+  phase = PHASE_IDLE;
+}
+
+bool TM1637Bus::selectDio(uint8_t dioPin) {
+  if (phase != PHASE_IDLE) {
+    return false;
+  }
+  this->dioPin = dioPin;
+  return true;
+}
+
+bool TM1637Bus::beginWrite(const uint8_t* segments, uint8_t pos, uint8_t length, uint8_t control) {
+  if (phase != PHASE_IDLE) {
+    return false;
+  }
+  if (length > TM1637_DIGITS) {
+    length = TM1637_DIGITS;
+  }
+
+  uint8_t n = 0;
+
+  // Frame 1: data command
+  queue[n++] = 1;
+  queue[n++] = TM1637_CMD_DATA_AUTO;
+
+  // Frame 2: start address + segment bytes
+  queue[n++] = 1 + length;
+  queue[n++] = TM1637_CMD_ADDRESS | (pos & 0x03);
+  for (uint8_t i = 0; i < length; i++) {
+    queue[n++] = segments[i];
+  }
+
+  // Frame 3: display control (brightness / on-off)
+  queue[n++] = 1;
+  queue[n++] = control;
+
+  queueLength = n;
+  queuePos = 0;
+  phase = PHASE_START;
+  return true;
+}
+
+void TM1637Bus::loadNextByte() {
+  currentByte = queue[queuePos++];
+  frameRemaining--;
+  bitIndex = 0;
+}
+
+void TM1637Bus::step() {
+  switch (phase) {
+    case PHASE_IDLE:
+      break;
+
+    case PHASE_START: // DIO falls while CLK is high
+      frameRemaining = queue[queuePos++];
+      lineLow(dioPin);
+      loadNextByte();
+      phase = PHASE_CLK_LOW;
+      break;
+
+    case PHASE_CLK_LOW:
+      lineLow(clkPin);
+      phase = PHASE_DATA;
+      break;
+
+    case PHASE_DATA: // LSB first
+      if (currentByte & 0x01) {
+        lineRelease(dioPin);
+      } else {
+        lineLow(dioPin);
+      }
+      currentByte >>= 1;
+      phase = PHASE_CLK_HIGH;
+      break;
+
+    case PHASE_CLK_HIGH:
+      lineRelease(clkPin);
+      bitIndex++;
+      phase = (bitIndex < 8) ? PHASE_CLK_LOW : PHASE_ACK_RELEASE;
+      break;
+
+    case PHASE_ACK_RELEASE: // Ninth clock - let the chip pull DIO low
+      lineLow(clkPin);
+      lineRelease(dioPin);
+      phase = PHASE_ACK_CLK_HIGH;
+      break;
+
+    case PHASE_ACK_CLK_HIGH:
+      lineRelease(clkPin);
+      if (digitalRead(dioPin) == LOW) {
+        lineLow(dioPin); // Hold low so the chip can release its ACK cleanly
+      }
+      phase = PHASE_ACK_CLK_LOW;
+      break;
+
+    case PHASE_ACK_CLK_LOW:
+      lineLow(clkPin);
+      if (frameRemaining > 0) {
+        loadNextByte();
+        phase = PHASE_DATA; // CLK is already low
+      } else {
+        phase = PHASE_STOP_DIO_LOW;
+      }
+      break;
+
+    case PHASE_STOP_DIO_LOW:
+      lineLow(dioPin);
+      phase = PHASE_STOP_CLK_HIGH;
+      break;
+
+    case PHASE_STOP_CLK_HIGH:
+      lineRelease(clkPin);
+      phase = PHASE_STOP_DIO_HIGH;
+      break;
+
+    case PHASE_STOP_DIO_HIGH: // DIO rises while CLK is high
+      lineRelease(dioPin);
+      phase = (queuePos < queueLength) ? PHASE_START : PHASE_IDLE;
+      break;
+  }
+}
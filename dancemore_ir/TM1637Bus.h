@@ -0,0 +1,86 @@
+/*
+ * TM1637Bus.h - Non-blocking TM1637 transfer engine
+ *
+ * Bit-bangs the TM1637 two-wire protocol one bus phase per step() call
+ * instead of blocking with bit delays like TM1637Display::setSegments.
+ * The caller (a scheduler task) provides the bit timing by calling step()
+ * periodically; each call only toggles one pin.
+ *
+ * Pins are driven open-drain style: OUTPUT (LOW) pulls the line down,
+ * INPUT releases it to the module's pull-up - same as the TM1637 library.
+ *
+ * Several modules can share one CLK line with a DIO line each: a module
+ * only latches data after a start condition on its own DIO, so clocking
+ * another module leaves it untouched. selectDio() switches between them.
+ */
+
+#ifndef TM1637_BUS_H
+#define TM1637_BUS_H
+
+#include <Arduino.h>
+
+#define TM1637_DIGITS 4
+
+// TM1637 command bytes
+#define TM1637_CMD_DATA_AUTO 0x40 // Write data, auto-increment address
+#define TM1637_CMD_ADDRESS   0xC0 // OR with start digit position
+#define TM1637_CMD_CONTROL   0x80 // OR with brightness (0-7) and display-on bit
+#define TM1637_CONTROL_ON    0x08
+
+class TM1637Bus {
+private:
+  // Bus phase - one pin change per step
+  enum Phase : uint8_t {
+    PHASE_IDLE,
+    PHASE_START,
+    PHASE_CLK_LOW,
+    PHASE_DATA,
+    PHASE_CLK_HIGH,
+    PHASE_ACK_RELEASE,
+    PHASE_ACK_CLK_HIGH,
+    PHASE_ACK_CLK_LOW,
+    PHASE_STOP_DIO_LOW,
+    PHASE_STOP_CLK_HIGH,
+    PHASE_STOP_DIO_HIGH
+  };
+
+  // Transaction queue: [frame length, bytes...] repeated, one start/stop each.
+  // Largest transaction: data command + address + 4 digits + control = 10 bytes
+  static const uint8_t QUEUE_SIZE = 2 + (2 + TM1637_DIGITS) + 2;
+
+  uint8_t clkPin, dioPin;
+  uint8_t queue[QUEUE_SIZE];
+  uint8_t queueLength;
+  uint8_t queuePos;        // Next byte to load
+  uint8_t frameRemaining;  // Bytes left in the current start/stop frame
+  uint8_t currentByte;
+  uint8_t bitIndex;
+  Phase phase;
+
+  void lineLow(uint8_t pin) { pinMode(pin, OUTPUT); }
+  void lineRelease(uint8_t pin) { pinMode(pin, INPUT); }
+  void loadNextByte();
+
+public:
+  // Constructor
+  TM1637Bus(uint8_t clkPin, uint8_t dioPin);
+
+  // Configure pins - call once from setup
+  void begin();
+
+  // True when no transaction is in flight
+  bool isIdle() const { return phase == PHASE_IDLE; }
+
+  // Address the module on `dioPin` for the next transaction (shared CLK).
+  // Returns false if a transaction is still in flight.
+  bool selectDio(uint8_t dioPin);
+
+  // Queue a write of `length` segment bytes starting at digit `pos`,
+  // followed by the display control byte. Returns false if still busy.
+  bool beginWrite(const uint8_t* segments, uint8_t pos, uint8_t length, uint8_t control);
+
+  // Advance the transaction by one bus phase
+  void step();
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * TaskScheduler.cpp - Cooperative tick scheduler implementation
+ */
+
+#include "TaskScheduler.h"
+#include <avr/wdt.h>
+
+#define WATCHDOG_RECORD_MAGIC 0xA55A // Power-on garbage matches 1 in 65536
+
+volatile uint8_t TaskScheduler::runningTask = TASK_NONE;
+
+// Written by the early-warning interrupt, read back after the reset.
+// .noinit keeps the C runtime from clearing it at boot.
+static uint16_t watchdogRecordMagic __attribute__((section(".noinit")));
+static uint8_t watchdogRecordTask __attribute__((section(".noinit")));
+static uint8_t lastWatchdogTask = TASK_NONE;
+static bool watchdogFired = false;
+
+// First timeout: note the culprit. The hardware clears WDIE on entry, so
+// unless the loop recovers and feeds the watchdog the next timeout resets.
+ISR(WDT_vect) {
+  watchdogRecordTask = TaskScheduler::currentTask();
+  watchdogRecordMagic = WATCHDOG_RECORD_MAGIC;
+}
+
+TaskScheduler::TaskScheduler()
+  : numTasks(0), criticalMask(0), onTimeMask(0), watchdogEnabled(false),
+    watchdogTimeout(WDTO_500MS) {
+}
+
+bool TaskScheduler::addTask(TaskFunction run, uint16_t periodMicros, const __FlashStringHelper* name,
+                            uint16_t maxLatencyMicros, bool critical) {
+  if (numTasks >= MAX_TASKS) {
+    return false;
+  }
+
+  Task &task = tasks[numTasks];
+  task.run = run;
+  task.name = name;
+  task.periodMicros = periodMicros;
+  task.maxLatencyMicros = maxLatencyMicros;
+  task.nextDeadline = micros();
+  task.misses = 0;
+  task.critical = critical;
+  if (critical) {
+    criticalMask |= (1 << numTasks);
+  }
+  numTasks++;
+  return true;
+}
+
+void TaskScheduler::begin() {
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < numTasks; i++) {
+    tasks[i].nextDeadline = now;
+  }
+
+  // Claim a record left by the watchdog interrupt before the last reset
+  if (watchdogRecordMagic == WATCHDOG_RECORD_MAGIC) {
+    lastWatchdogTask = watchdogRecordTask;
+    watchdogFired = true;
+  }
+  watchdogRecordMagic = 0;
+}
+
+void TaskScheduler::run() {
+  for (uint8_t i = 0; i < numTasks; i++) {
+    Task &task = tasks[i];
+    unsigned long now = micros();
+
+    // Signed difference keeps the comparison correct across micros() rollover
+    if ((long)(now - task.nextDeadline) < 0) {
+      continue;
+    }
+
+    runningTask = i;
+    task.run();
+    runningTask = TASK_NONE;
+
+    bool onTime = task.maxLatencyMicros == 0 ||
+                  (unsigned long)(micros() - task.nextDeadline) <= task.maxLatencyMicros;
+    if (!onTime && task.misses < 0xFFFF) {
+      task.misses++;
+    }
+    if (task.critical && onTime) {
+      onTimeMask |= (1 << i);
+    }
+
+    // Advance by whole periods so cadence doesn't drift with task runtime,
+    // but resync if we fell more than a period behind
+    task.nextDeadline += task.periodMicros;
+    if ((long)(now - task.nextDeadline) >= 0) {
+      task.nextDeadline = now + task.periodMicros;
+    }
+  }
+
+  // Feed only once every critical task has kept its budget since the last feed
+  if (watchdogEnabled && (onTimeMask & criticalMask) == criticalMask) {
+    wdt_reset();
+    WDTCSR |= _BV(WDIE); // Re-arm the early warning if it fired and we recovered
+    onTimeMask = 0;
+  }
+}
+
+unsigned long TaskScheduler::timeUntilNextDeadline() {
+  unsigned long now = micros();
+  unsigned long earliest = 0xFFFFFFFFUL;
+
+  for (uint8_t i = 0; i < numTasks; i++) {
+    long remaining = (long)(tasks[i].nextDeadline - now);
+    if (remaining <= 0) {
+      return 0;
+    }
+    if ((unsigned long)remaining < earliest) {
+      earliest = remaining;
+    }
+  }
+  return earliest;
+}
+
+void TaskScheduler::enableWatchdog(uint8_t timeout) {
+  watchdogTimeout = timeout;
+  onTimeMask = 0;
+  wdt_enable(timeout);
+  WDTCSR |= _BV(WDIE); // Interrupt first, reset on the following timeout
+  watchdogEnabled = true;
+}
+
+void TaskScheduler::suspendWatchdog() {
+  if (watchdogEnabled) {
+    wdt_disable();
+  }
+}
+
+void TaskScheduler::resumeWatchdog() {
+  if (watchdogEnabled) {
+    enableWatchdog(watchdogTimeout);
+  }
+}
+
+void TaskScheduler::printMisses() {
+  Serial.print(F("STAT misses"));
+  for (uint8_t i = 0; i < numTasks; i++) {
+    Serial.print(' ');
+    if (tasks[i].name != nullptr) {
+      Serial.print(tasks[i].name);
+    } else {
+      Serial.print(i);
+    }
+    Serial.print('=');
+    Serial.print(tasks[i].misses);
+  }
+  Serial.println();
+}
+
+void TaskScheduler::resetMisses() {
+  for (uint8_t i = 0; i < numTasks; i++) {
+    tasks[i].misses = 0;
+  }
+}
+
+void TaskScheduler::printLastWatchdog() {
+  if (!watchdogFired) {
+    return;
+  }
+  Serial.print(F("STAT watchdog fired in "));
+  if (lastWatchdogTask < numTasks && tasks[lastWatchdogTask].name != nullptr) {
+    Serial.println(tasks[lastWatchdogTask].name);
+  } else if (lastWatchdogTask < numTasks) {
+    Serial.println(lastWatchdogTask);
+  } else {
+    Serial.println(F("loop (no task running)"));
+  }
+}
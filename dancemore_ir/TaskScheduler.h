@@ -0,0 +1,102 @@
+/*
+ * TaskScheduler.h - Cooperative tick scheduler
+ *
+ * Replaces the fixed delay() at the end of loop() with a small task table.
+ * Each task has a period and a next deadline in microseconds; run() executes
+ * every task whose deadline has passed and otherwise returns immediately, so
+ * the main loop only waits until the earliest pending deadline.
+ *
+ * A task may also declare a latency budget: the time from becoming due to
+ * finishing its run. Runs that blow it count as misses. Once the watchdog
+ * is enabled it is fed only after every critical task has met its budget
+ * since the last feed, so a wedged bus or a stalled loop ends in a reset
+ * instead of a hang. The watchdog's early-warning interrupt records which
+ * task was running; that survives the reset and is reported afterwards.
+ */
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+// Millisecond cadence for animations driven from a task: true once
+// `interval` has passed since `last`. The deadline steps by whole
+// intervals so the cadence stays exact, and resyncs to `now` after a
+// stall (or on the first step) instead of bursting to catch up.
+inline bool stepCadence(unsigned long& last, unsigned long now, uint16_t interval) {
+  unsigned long elapsed = now - last;
+  if (elapsed < interval) {
+    return false;
+  }
+  if (elapsed >= 2UL * interval) {
+    last = now;
+  } else {
+    last += interval;
+  }
+  return true;
+}
+
+// Task callbacks take no arguments - wrap object methods in a free function
+typedef void (*TaskFunction)();
+
+#define TASK_NONE 0xFF // No task running (between tasks or asleep)
+
+struct Task {
+  TaskFunction run;
+  const __FlashStringHelper* name;
+  uint16_t periodMicros;     // 0 = run on every scheduler pass
+  uint16_t maxLatencyMicros; // Due-to-finished budget, 0 = none
+  unsigned long nextDeadline; // micros() timestamp of the next run
+  uint16_t misses;           // Runs that finished over budget
+  bool critical;             // Watchdog feeding depends on this task
+};
+
+class TaskScheduler {
+private:
+  static const uint8_t MAX_TASKS = 8;
+
+  Task tasks[MAX_TASKS];
+  uint8_t numTasks;
+
+  uint8_t criticalMask;  // Bit per critical task
+  uint8_t onTimeMask;    // Critical tasks that met their budget since the last feed
+  bool watchdogEnabled;
+  uint8_t watchdogTimeout;
+
+  static volatile uint8_t runningTask; // Read by the watchdog interrupt
+
+public:
+  // Constructor
+  TaskScheduler();
+
+  // Register a task - returns false if the table is full
+  bool addTask(TaskFunction run, uint16_t periodMicros, const __FlashStringHelper* name = nullptr,
+               uint16_t maxLatencyMicros = 0, bool critical = false);
+
+  // Anchor all task deadlines to the current time
+  void begin();
+
+  // Run every task that is due; call this from loop()
+  void run();
+
+  // Microseconds until the earliest deadline (0 if something is due)
+  unsigned long timeUntilNextDeadline();
+
+  // Watchdog in interrupt-then-reset mode (timeout = WDTO_* constant).
+  // suspend/resume bracket deliberate long blocking work.
+  void enableWatchdog(uint8_t timeout);
+  void suspendWatchdog();
+  void resumeWatchdog();
+
+  // Deadline accounting, printed as part of STAT:
+  void printMisses();
+  void resetMisses();
+
+  // Task running when the watchdog last fired before a reset
+  void printLastWatchdog();
+
+  // Index of the task inside run(), or TASK_NONE
+  static uint8_t currentTask() { return runningTask; }
+};
+
+#endif
@@ -1,13 +1,40 @@
 #include <IRremote.h>
+#include <avr/wdt.h>
 #include "LEDAnimations.h"
 #include "DisplayController.h"
+#include "DisplayAnimations.h"
+#include "SceneEngine.h"
 #include "StringConstants.h"
+#include "BuildProfile.h"
+#include "TaskScheduler.h"
+#include "CommandRegistry.h"
+#include "BinaryProtocol.h"
+#include "SerialOutput.h"
+#include "IREventQueue.h"
+#include "LoopStats.h"
+#include "Benchmark.h"
+#include "IdleSleep.h"
+#include "PersistentConfig.h"
+#include "IRMacros.h"
+#include "RawStream.h"
+#include "CaptureHistory.h"
+#include "FlipperExport.h"
+#include "HoldTracker.h"
+#include "MemoryMonitor.h"
+#include "LEDStrip.h"
 
 // TM1637 Display Configuration
 const int CLK = 5;
 const int DIO = 4;
 DisplayController displayController(CLK, DIO);
 
+// Extra modules chained on the same CLK line, displayed left to right after
+// the first one. List one DIO pin per module; 0 (the RX pin) marks unused.
+const uint8_t CHAINED_DISPLAY_DIO[] = {0};
+
+// Non-blocking display effects (DISP:ANIM:)
+DisplayAnimations displayAnimations(displayController);
+
 // RGB LED Configuration
 const int RED_PIN = 9;
 const int GREEN_PIN = 6;
@@ -16,24 +43,401 @@ const int BLUE_PIN = 3;
 // LED Animation object
 LEDAnimations ledAnimations(RED_PIN, GREEN_PIN, BLUE_PIN);
 
+// One animation timebase for LED and display effects (SCENE:)
+SceneEngine sceneEngine(ledAnimations, displayAnimations, displayController);
+
 // Configuration (will be overridden by jumper detection)
-bool DEBUG_MODE = false;                 // Determined by jumper on pin 10
-const bool SHOW_REPEATS = false;        // Set to true to show repeat signals in debug mode
-const bool SHOW_RAW_DATA = false;       // Set to true to show raw hex values in debug mode
+bool DEBUG_MODE = false;                 // Determined by jumper on pin 10 - test it through
+                                         // BuildProfile::debug() so lean builds drop debug code
+bool SHOW_REPEATS = false;              // Show hold summaries in debug mode (CFG:VERB bit 0)
+bool SHOW_RAW_DATA = false;             // Show raw hex values in debug mode (CFG:VERB bit 1)
 const unsigned long BAUD_RATE = 115200; // Serial communication speed
 
 // Pin configuration
 const int IR_RECEIVE_PIN = 2;
 const int DEBUG_JUMPER_PIN = 10;         // Pin 10 to GND = debug mode
 
-// Statistics tracking
+// Statistics tracking - every non-noise frame, and the non-repeats among them
 unsigned long totalSignals = 0;
 unsigned long validSignals = 0;
-unsigned long lastSignalTime = 0;
+unsigned long statsPrintedAt = 0; // totalSignals at the last [Stats:] line
+unsigned long lastSignalTime = 0; // micros() capture time of the previous frame
+
+// Cooperative scheduler - replaces the fixed delay() in loop()
+TaskScheduler scheduler;
+const uint16_t IR_POLL_PERIOD_US = 250;    // IR decode check
+const uint16_t SERIAL_POLL_PERIOD_US = 500; // 64-byte RX buffer fills in ~5.5ms at 115200
+const uint16_t ANIMATION_PERIOD_US = 1000;  // Effects gate themselves on their intervals
+const uint16_t DISPLAY_BUS_PERIOD_US = 50;  // One TM1637 bus phase per tick
+const uint16_t STRIP_PUSH_PERIOD_US = 1000; // LEDStrip caps the frame rate itself
+const uint8_t WATCHDOG_TIMEOUT = WDTO_500MS; // Longest EEPROM burst (LEARN:) stays well inside
+
+// Scheduler tasks, defined after setup(). Declared here so the sketch also
+// compiles as plain C++ (host/), without the Arduino builder's prototypes.
+void pollIR();
+void processIREvents();
+void processSerialCommand();
+void updateAnimations();
+void updateDisplay();
+void pumpSerialOutput();
+void pushLEDStrip();
+
+// Stage timing exposed through STAT:
+LoopStats loopStats;
+
+// Decoded frames wait here between capture (pollIR) and output (processIREvents)
+IREventQueue irEvents;
+const uint16_t IR_CONSUMER_PERIOD_US = 1000;
+
+// Folds repeat frames into press / held / release (HOLD:)
+HoldTracker holdTracker;
+
+// Binary raw-timing bursts (RAW:ON / RAW:ALL), drained ahead of text output
+RawStream rawStream;
+
+// Non-blocking IR event output: render into eventLine, queue into txRing
+LineBuffer eventLine;
+TxRing txRing;
+const uint16_t TX_PUMP_PERIOD_US = 500; // UART drains ~58 bytes per 5ms at 115200
+
+// Recent valid frames, replayed as Flipper .ir records by EXPORT:DUMP
+const __FlashStringHelper* getFlipperProtocolName(uint8_t protocol);
+CaptureHistory captureHistory;
+FlipperExport flipperExport(txRing, captureHistory, getFlipperProtocolName);
+
+// HIST:LAST replay in progress - streamed from the serial pump task
+bool historyReplaying = false;
+uint16_t historyReplaySequence = 0;
+uint16_t historyReplayEnd = 0;
 
 // Buffer for serial commands - avoid String class
-char commandBuffer[32];
+char commandBuffer[48]; // Room for DISP:SCROLL: plus a 32-character message
 uint8_t commandIndex = 0;
+unsigned long lastSerialRxMicros = 0; // micros() of the last byte read - LEDStrip waits for a quiet line
+
+// Command route handlers - args point into commandBuffer past the prefix
+bool handleDisplayCommand(char* args) {
+  StatProbe probe(loopStats, STAT_DISPLAY_COMMAND);
+
+  // New content replaces a running effect; BRT/ON/OFF leave it running
+  if (strncasecmp_P(args, PSTR("BRT:"), 4) != 0 && strcasecmp_P(args, PSTR("ON")) != 0 &&
+      strcasecmp_P(args, PSTR("OFF")) != 0) {
+    sceneEngine.release();
+    displayAnimations.stop();
+  }
+  return displayController.processCommand(args);
+}
+
+bool handleDisplayAnimationCommand(char* args) {
+  sceneEngine.release();
+  return displayAnimations.processCommand(args);
+}
+
+bool handleLEDCommand(char* args) {
+  sceneEngine.release();
+  return ledAnimations.processCommand(args);
+}
+
+bool handleSceneCommand(char* args) {
+  return sceneEngine.processCommand(args);
+}
+
+// Push the live config into the running objects. Output mode only
+// changes at the next boot - every module latches debug mode in begin().
+void applyConfig() {
+  const DeviceConfig& config = PersistentConfig::current;
+  SHOW_REPEATS = config.verbosity & CONFIG_VERBOSE_REPEATS;
+  SHOW_RAW_DATA = config.verbosity & CONFIG_VERBOSE_RAW;
+  displayController.setBrightness(config.brightness);
+}
+
+bool handleLearnCommand(char* args) {
+  return IRMacros::processCommand(args);
+}
+
+bool handleRawCommand(char* args) {
+  return rawStream.processCommand(args);
+}
+
+// HIST:LAST [n] replays the newest n captures (all if omitted),
+// HIST:COUNT <addr>:<cmd> (hex) counts one code, HIST:CLEAR empties it
+bool handleHistoryCommand(char* args) {
+  if (strncasecmp_P(args, PSTR("LAST"), 4) == 0) {
+    uint8_t wanted = captureHistory.count();
+    if (args[4] == ' ' || args[4] == ':') {
+      int n = atoi(args + 5);
+      if (n < wanted) {
+        wanted = n < 0 ? 0 : n;
+      }
+    } else if (args[4] != '\0') {
+      return false;
+    }
+    historyReplayEnd = captureHistory.endSequence();
+    historyReplaySequence = historyReplayEnd - wanted;
+    historyReplaying = true;
+    return true;
+  }
+
+  if (strncasecmp_P(args, PSTR("COUNT "), 6) == 0 || strncasecmp_P(args, PSTR("COUNT:"), 6) == 0) {
+    char* cursor = args + 6;
+    uint16_t address = strtoul(cursor, &cursor, 16);
+    if (*cursor != ':') {
+      return false;
+    }
+    uint16_t command = strtoul(cursor + 1, nullptr, 16);
+    Serial.print(F("HIST COUNT A:0x"));
+    Serial.print(address, HEX);
+    Serial.print(F(" C:0x"));
+    Serial.print(command, HEX);
+    Serial.print(F(" N:"));
+    Serial.println(captureHistory.countOf(address, command));
+    return true;
+  }
+
+  if (strcasecmp_P(args, PSTR("CLEAR")) == 0) {
+    captureHistory.clear();
+    historyReplaying = false;
+    Serial.println(F("HIST cleared"));
+    return true;
+  }
+  return false;
+}
+
+bool handleHoldCommand(char* args) {
+  return holdTracker.processCommand(args);
+}
+
+bool handleExportCommand(char* args) {
+  return flipperExport.processCommand(args);
+}
+
+// Only push settings the command actually changed, so printing or saving
+// the config doesn't undo a runtime DISP:BRT or repeat/raw toggle
+bool handleConfigCommand(char* args) {
+  const DeviceConfig before = PersistentConfig::current;
+  bool handled = PersistentConfig::processCommand(args);
+  const DeviceConfig& after = PersistentConfig::current;
+  if (after.verbosity != before.verbosity) {
+    SHOW_REPEATS = after.verbosity & CONFIG_VERBOSE_REPEATS;
+    SHOW_RAW_DATA = after.verbosity & CONFIG_VERBOSE_RAW;
+  }
+  if (after.brightness != before.brightness) {
+    displayController.setBrightness(after.brightness);
+  }
+  return handled;
+}
+
+// STAT: prints stage timings and drop counters, STAT:RESET clears them
+bool handleStatCommand(char* args) {
+  if (strcasecmp_P(args, PSTR("RESET")) == 0) {
+    loopStats.reset();
+    scheduler.resetMisses();
+    Serial.println(F("STAT reset"));
+    return true;
+  }
+
+  loopStats.print();
+  Serial.print(F("STAT drops tx="));
+  Serial.print(txRing.droppedCount());
+  Serial.print(F(" ir="));
+  Serial.print(irEvents.overflowCount());
+  Serial.print(F(" raw="));
+  Serial.println(rawStream.droppedCount());
+  if (BuildProfile::ledStrip) {
+    Serial.print(F("STAT strip frames="));
+    Serial.print(LEDStrip::pushedCount());
+    Serial.print(F(" deferred="));
+    Serial.print(LEDStrip::deferredCount());
+    Serial.print(F(" overruns="));
+    Serial.println(LEDStrip::overrunCount());
+  }
+  scheduler.printMisses();
+  scheduler.printLastWatchdog();
+#if ENABLE_IDLE_SLEEP
+  Serial.print(F("STAT sleep n="));
+  Serial.print(IdleSleep::sleepCount());
+  Serial.print(F(" ms="));
+  Serial.println(IdleSleep::totalSleptMicros() / 1000UL);
+#endif
+  return true;
+}
+
+// MEM: prints RAM headroom, static allocation per subsystem and the reset cause
+bool handleMemoryCommand(char* args) {
+  if (args[0] != '\0') {
+    return false;
+  }
+
+  Serial.print(F("MEM free="));
+  Serial.print(MemoryMonitor::freeRam());
+  Serial.print(F(" min="));
+  Serial.print(MemoryMonitor::minimumFreeRam());
+  Serial.print(F(" heap="));
+  Serial.print(MemoryMonitor::heapPeak());
+  Serial.print(F(" static="));
+  Serial.print(MemoryMonitor::staticRam());
+  Serial.print(F(" pool="));
+  Serial.println(STRING_POOL_BYTES);
+
+  Serial.print(F("MEM led="));
+  Serial.print(sizeof(ledAnimations) + (BuildProfile::ledStrip ? LEDStrip::PIXELS * 3 : 0));
+  Serial.print(F(" disp="));
+  Serial.print(sizeof(displayController));
+  Serial.print(F(" fx="));
+  Serial.print(sizeof(displayAnimations) + sizeof(sceneEngine));
+  Serial.print(F(" ir="));
+  Serial.print(sizeof(irEvents));
+  Serial.print(F(" tx="));
+  Serial.print(sizeof(txRing) + sizeof(eventLine));
+  Serial.print(F(" raw="));
+  Serial.print(sizeof(rawStream));
+  Serial.print(F(" hist="));
+  Serial.print(sizeof(captureHistory));
+  Serial.print(F(" stat="));
+  Serial.print(sizeof(loopStats));
+  Serial.print(F(" cmd="));
+  Serial.println(sizeof(commandBuffer) + sizeof(FrameParser));
+
+  Serial.print(F("MEM reset:"));
+  MemoryMonitor::printResetCause();
+  return true;
+}
+
+#if ENABLE_BENCHMARK
+// Recorded IR trace for BENCH:REPLAY - a short remote session with a repeat
+// and a noise frame, so every output branch is exercised
+const IREvent BENCH_IR_TRACE[] PROGMEM = {
+  // protocol, flags, bits, address, command, rawData, timestamp
+  {NEC, 0, 32, 0x0004, 0x0008, 0xF708FB04UL, 0},
+  {NEC, IRDATA_FLAGS_IS_REPEAT, 32, 0x0004, 0x0008, 0xF708FB04UL, 0},
+  {SONY, 0, 12, 0x0001, 0x0015, 0x00000095UL, 0},
+  {SAMSUNG, 0, 32, 0x0707, 0x0002, 0xFD020707UL, 0},
+  {UNKNOWN, 0, 0, 0x0000, 0x0000, 0x00000000UL, 0}
+};
+
+bool dispatchBenchLine(char* line);
+void handleIREvent(const IREvent& event);
+
+// Block until the UART and the display bus have caught up
+void drainBenchOutput() {
+  while (!txRing.isEmpty()) {
+    txRing.pump();
+  }
+  Serial.flush();
+  displayController.flush();
+}
+
+uint32_t benchSegmentBytes() {
+  return displayController.changedSegmentCount();
+}
+
+uint32_t benchTxBytes() {
+  return txRing.queuedByteCount();
+}
+
+// BENCH:REPLAY runs the recorded command stream and IR trace,
+// BENCH:CYCLES prints Timer1 cycle counts for the hot paths
+bool handleBenchCommand(char* args) {
+  bool replay = (strcasecmp_P(args, PSTR("REPLAY")) == 0);
+  if (!replay && strcasecmp_P(args, PSTR("CYCLES")) != 0) {
+    return false;
+  }
+
+  BenchTarget target;
+  target.dispatch = dispatchBenchLine;
+  target.replayIREvent = handleIREvent;
+  target.drainOutput = drainBenchOutput;
+  target.segmentBytes = benchSegmentBytes;
+  target.txBytes = benchTxBytes;
+  target.irTrace = BENCH_IR_TRACE;
+  target.irTraceLength = sizeof(BENCH_IR_TRACE) / sizeof(BENCH_IR_TRACE[0]);
+  target.leds = &ledAnimations;
+
+  // Benchmarks hold the loop for seconds on purpose
+  scheduler.suspendWatchdog();
+  if (replay) {
+    runReplayBenchmark(target);
+  } else {
+    runCycleBenchmark(target);
+  }
+  scheduler.resumeWatchdog();
+  return true;
+}
+#endif
+
+// Prefix routing table - parsed once per line, no String copies
+const CommandRoute commandRoutes[] PROGMEM = {
+  {"DISP:ANIM:", handleDisplayAnimationCommand}, // Before DISP: - first match wins
+  {"DISP:", handleDisplayCommand},
+  {"LED:", handleLEDCommand},
+  {"SCENE:", handleSceneCommand},
+  {"CFG:", handleConfigCommand},
+  {"LEARN:", handleLearnCommand},
+  {"RAW:", handleRawCommand},
+  {"EXPORT:", handleExportCommand},
+  {"HOLD:", handleHoldCommand},
+  {"HIST:", handleHistoryCommand},
+  {"STAT:", handleStatCommand},
+  {"MEM:", handleMemoryCommand},
+#if ENABLE_BENCHMARK
+  {"BENCH:", handleBenchCommand},
+#endif
+};
+
+const uint8_t NUM_COMMAND_ROUTES = sizeof(commandRoutes) / sizeof(commandRoutes[0]);
+
+#if ENABLE_BENCHMARK
+// Replayed lines go through the same routing table as live serial input
+bool dispatchBenchLine(char* line) {
+  return dispatchCommand(line, commandRoutes, NUM_COMMAND_ROUTES);
+}
+#endif
+
+// Binary frame parser - runs alongside the text commands
+FrameParser frameParser;
+
+// Execute one op from a binary frame
+bool executeFrameOp(uint8_t opcode, const uint8_t* data, uint8_t length) {
+  switch (opcode) {
+    case OP_TEXT_COMMAND: {
+      char text[FRAME_MAX_PAYLOAD + 1];
+      memcpy(text, data, length);
+      text[length] = '\0';
+      return dispatchCommand(text, commandRoutes, NUM_COMMAND_ROUTES);
+    }
+
+    case OP_LED_ANIMATION: {
+      if (length != 3 || data[0] > ANIM_CUSTOM) return false;
+      // startAnimation takes an int - keep the duration within its range
+      uint16_t seconds = data[1] | ((uint16_t)data[2] << 8);
+      if (seconds > OP_LED_MAX_DURATION) return false;
+      sceneEngine.release();
+      ledAnimations.startAnimation(data[0], seconds);
+      return true;
+    }
+
+    case OP_LED_OFF:
+      sceneEngine.release();
+      ledAnimations.off();
+      return true;
+
+    case OP_DISP_SEGMENTS: // 4 bytes per module, starting at module 0
+      if (length == 0 || length % TM1637_DIGITS != 0 ||
+          length > displayController.digitCount()) return false;
+      sceneEngine.release();
+      displayAnimations.stop();
+      for (uint8_t module = 0; module < length / TM1637_DIGITS; module++) {
+        displayController.displaySegments(module, data + module * TM1637_DIGITS);
+      }
+      return true;
+
+    case OP_DISP_BRIGHTNESS:
+      if (length != 1 || data[0] > 7) return false;
+      displayController.setBrightness(data[0]);
+      return true;
+  }
+  return false;
+}
 
 // Check if debug jumper is installed
 bool isDebugJumperInstalled() {
@@ -42,29 +446,38 @@ bool isDebugJumperInstalled() {
   return digitalRead(DEBUG_JUMPER_PIN) == LOW; // LOW = jumper to ground
 }
 
-// Process serial commands for display and LED control - optimized version
+// Process serial commands for display and LED control - drains the whole
+// RX buffer each tick, handling both text lines and binary frames
 void processSerialCommand() {
+  unsigned long now = millis();
+  frameParser.checkTimeout(now);
+
   while (Serial.available()) {
     char c = Serial.read();
-    
+    lastSerialRxMicros = micros();
+
+    // Binary frames start with a sync byte that never appears in text commands
+    if (frameParser.isActive() || (commandIndex == 0 && (uint8_t)c == FRAME_SYNC)) {
+      FrameParser::Result result = frameParser.feed(c, now);
+      if (result == FrameParser::FRAME_COMPLETE) {
+        txRing.drain(); // The ACK and any op replies are direct writes
+        frameParser.execute(executeFrameOp);
+      } else if (result == FrameParser::FRAME_ERROR) {
+        txRing.drain();
+        frameParser.rejectFrame();
+      }
+      continue;
+    }
+
     if (c == '\n' || c == '\r') {
       if (commandIndex > 0) {
         commandBuffer[commandIndex] = '\0'; // Null terminate
         
-        // Try display controller first
-        if (displayController.processCommand(commandBuffer)) {
-          commandIndex = 0;
-          return;
-        }
-        
-        // Try LED controller
-        if (ledAnimations.processCommand(commandBuffer)) {
-          commandIndex = 0;
-          return;
-        }
-        
-        // Unknown command
-        if (DEBUG_MODE) {
+        // Route by prefix to the display or LED controller. Handlers reply
+        // with direct writes, so finish the queued output first.
+        txRing.drain();
+        if (!dispatchCommand(commandBuffer, commandRoutes, NUM_COMMAND_ROUTES) && BuildProfile::debug(DEBUG_MODE)) {
+          // Unknown command
           Serial.println(F("Commands: DISP:text, DISP:CLR, DISP:ON, DISP:OFF, DISP:BRT:n"));
           ledAnimations.printHelp();
         }
@@ -87,229 +500,485 @@ void setup() {
   pinMode(GREEN_PIN, OUTPUT);
   pinMode(BLUE_PIN, OUTPUT);
 
+  // Stored settings - falls back to defaults on a blank or corrupt block
+  PersistentConfig::load();
+  IRMacros::begin();
+  bool fastBoot = PersistentConfig::fastBoot();
+
   // DIAGNOSTIC: Check jumper status
   pinMode(DEBUG_JUMPER_PIN, INPUT_PULLUP);
-  delay(10); // Minimal delay for stable reading
+  if (fastBoot) {
+    delayMicroseconds(100); // The pull-up settles in microseconds
+  } else {
+    delay(10); // Minimal delay for stable reading
+  }
 
   bool jumperDetected = (digitalRead(DEBUG_JUMPER_PIN) == LOW);
-  DEBUG_MODE = jumperDetected;
+  switch (PersistentConfig::current.outputMode) {
+    case CONFIG_OUTPUT_FLIPPER: DEBUG_MODE = false; break;
+    case CONFIG_OUTPUT_DEBUG: DEBUG_MODE = true; break;
+    default: DEBUG_MODE = jumperDetected; break;
+  }
+  DEBUG_MODE = BuildProfile::debug(DEBUG_MODE);
+  applyConfig();
 
   // Initialize display controller
   displayController.setDebugMode(DEBUG_MODE);
-  displayController.begin();
+  for (uint8_t i = 0; i < sizeof(CHAINED_DISPLAY_DIO); i++) {
+    if (CHAINED_DISPLAY_DIO[i] != 0) {
+      displayController.addModule(CHAINED_DISPLAY_DIO[i]);
+    }
+  }
+  displayController.begin(!fastBoot);
+  displayAnimations.begin(DEBUG_MODE);
 
   // Initialize LED animations
   ledAnimations.begin(DEBUG_MODE);
+  sceneEngine.begin(DEBUG_MODE);
 
   // Initialize IR receiver
   IrReceiver.begin(IR_RECEIVE_PIN, ENABLE_LED_FEEDBACK);
+#if ENABLE_IDLE_SLEEP
+  IdleSleep::begin(IR_RECEIVE_PIN);
+#endif
 
   // Reduced startup messages and delays
-  if (DEBUG_MODE) {
-    // Debug mode startup - use F() macro for string literals
-    Serial.println(F("=== Arduino IR Receiver + TM1637 Display + Enhanced RGB LED (DEBUG MODE) ==="));
-    Serial.println(F("Configuration:"));
-    Serial.println(F("  - Debug Jumper: INSTALLED (Pin 10 -> GND)"));
-    Serial.println(F("  - Debug Mode: ON"));
-    Serial.print(F("  - Show Repeats: ")); Serial.println(SHOW_REPEATS ? F("ON") : F("OFF"));
-    Serial.print(F("  - Show Raw Data: ")); Serial.println(SHOW_RAW_DATA ? F("ON") : F("OFF"));
-    Serial.print(F("  - Baud Rate: ")); Serial.println(BAUD_RATE);
-    Serial.println(F("  - Display: TM1637 4-Digit 7-Segment"));
-    Serial.println(F("  - RGB LED: Common Anode (Pins 9,6,3)"));
-    Serial.println();
-    Serial.println(F("Display Commands:"));
-    StringManager::printDisplayHelp();
-    Serial.println();
-    Serial.println(F("Enhanced LED Animation Commands:"));
-    StringManager::printLEDHelp();
-    Serial.println();
-    Serial.println(F("Remove jumper and restart for production mode"));
-    Serial.println(F("Waiting for IR signals and commands..."));
-    Serial.println(F("Format: Protocol | Address | Command | Raw Value | Bits | Time"));
-    Serial.println(F("---"));
+  if (BuildProfile::debug(DEBUG_MODE)) {
+    // Debug mode startup - banner and help stream from the string pool
+    StringManager::printDebugBanner(SHOW_REPEATS, SHOW_RAW_DATA, BAUD_RATE);
+    Serial.print(StringManager::flash(DEBUG_STORED)); PersistentConfig::print();
+    StringManager::printDebugHelp();
 
     // Show "REDY" on display in debug mode
     displayController.showReady();
 
   } else {
     // Flipper Zero compatible startup - minimal output
-    Serial.println(F("ir rx"));
-    Serial.println(F("Receiving..."));
-    Serial.println(F("Press Ctrl+C to stop"));
+    StringManager::printProductionBanner();
     
     // Show "----" on display in production mode
     displayController.showDashes();
   }
 
-  // Reduced welcome flash delay
-  delay(200);
-  ledAnimations.flashAck();
-}
+  // Welcome flash, or the configured animation looped from boot
+  if (!fastBoot) {
+    delay(200);
+  }
+  if (PersistentConfig::current.defaultAnimation != CONFIG_NO_ANIMATION) {
+    ledAnimations.startAnimation(PersistentConfig::current.defaultAnimation, 0);
+  } else {
+    ledAnimations.flashAck();
+  }
 
-// Convert protocol names to match Flipper Zero format - handle FlashStringHelper
-String getFlipperProtocolName(String arduinoProtocol) {
-  if (arduinoProtocol == "Sony") return "SIRC";
-  if (arduinoProtocol == "Samsung32") return "Samsung32";
-  if (arduinoProtocol == "Samsung") return "Samsung32";
-  // Most others match directly
-  return arduinoProtocol;
+  // Register scheduler tasks - order is the run order within a pass
+  // Latency budgets: the RX and TX hardware buffers cover ~5.5ms at 115200;
+  // IR polling and the serial drain are critical and gate the watchdog
+  scheduler.addTask(pollIR, IR_POLL_PERIOD_US, F("ir"), 5000, true);
+  scheduler.addTask(processIREvents, IR_CONSUMER_PERIOD_US, F("irout"), 20000);
+  scheduler.addTask(processSerialCommand, SERIAL_POLL_PERIOD_US, F("rx"), 5000);
+  scheduler.addTask(updateAnimations, ANIMATION_PERIOD_US, F("anim"), 10000);
+  scheduler.addTask(updateDisplay, DISPLAY_BUS_PERIOD_US, F("disp"), 5000);
+  scheduler.addTask(pumpSerialOutput, TX_PUMP_PERIOD_US, F("tx"), 5000, true);
+  if (BuildProfile::ledStrip) {
+    scheduler.addTask(pushLEDStrip, STRIP_PUSH_PERIOD_US, F("strip"), 5000);
+  }
+  scheduler.begin();
+  scheduler.enableWatchdog(WATCHDOG_TIMEOUT);
 }
 
-// Format hex values with proper padding - optimized version
-void printHex(uint32_t value, uint8_t minDigits = 2) {
-  char buffer[9]; // Max 8 hex digits + null terminator
-  
-  // Handle special case of 0
-  if (value == 0) {
-    for (uint8_t i = 0; i < minDigits; i++) {
-      Serial.print('0');
+// Flipper Zero names for protocols IRremote spells differently
+struct ProtocolAlias {
+  uint8_t protocol;  // decode_type_t
+  const char* name;  // PROGMEM string
+};
+
+const ProtocolAlias FLIPPER_PROTOCOL_ALIASES[] PROGMEM = {
+  {SONY, PROTOCOL_SIRC},
+  {SAMSUNG, PROTOCOL_SAMSUNG32}
+};
+
+const uint8_t NUM_PROTOCOL_ALIASES = sizeof(FLIPPER_PROTOCOL_ALIASES) / sizeof(FLIPPER_PROTOCOL_ALIASES[0]);
+
+// Map a protocol id to its Flipper name at print time - flash only, no String.
+// Everything else uses IRremote's own PROGMEM name table, indexed by protocol.
+const __FlashStringHelper* getFlipperProtocolName(uint8_t protocol) {
+  for (uint8_t i = 0; i < NUM_PROTOCOL_ALIASES; i++) {
+    if (pgm_read_byte(&FLIPPER_PROTOCOL_ALIASES[i].protocol) == protocol) {
+      return (const __FlashStringHelper*)pgm_read_ptr(&FLIPPER_PROTOCOL_ALIASES[i].name);
     }
-    return;
-  }
-  
-  // Convert to hex string
-  uint8_t digits = 0;
-  uint32_t temp = value;
-  
-  // Count digits needed
-  while (temp > 0) {
-    temp >>= 4;
-    digits++;
-  }
-  
-  // Print leading zeros if needed
-  while (digits < minDigits) {
-    Serial.print('0');
-    digits++;
   }
-  
-  // Print the hex value
-  Serial.print(value, HEX);
+  return getProtocolString((decode_type_t)protocol);
 }
 
-// Print detailed debug information - optimized
-void printDebugInfo(String protocol, uint16_t address, uint16_t command,
-                   uint32_t rawValue, uint8_t bits, bool isRepeat) {
+// Queue the rendered eventLine as one line; false if the TX ring was full
+bool queueEventLine() {
+  eventLine.appendNewline();
+  return txRing.enqueue(eventLine);
+}
 
-  totalSignals++;
-  unsigned long currentTime = millis();
+// Print detailed debug information - rendered per line into the TX ring
+void printDebugInfo(uint8_t protocol, uint16_t address, uint16_t command,
+                   uint32_t rawValue, uint8_t bits, bool isRepeat,
+                   unsigned long captureMicros) {
 
-  if (!isRepeat) {
-    validSignals++;
-  }
+  unsigned long currentTime = captureMicros;
 
   // Main data line
-  Serial.print(protocol);
-  Serial.print(F(" | A:0x"));
-  printHex(address);
-  Serial.print(F(" | C:0x"));
-  printHex(command);
+  eventLine.clear();
+  eventLine.append(getFlipperProtocolName(protocol));
+  eventLine.append(F(" | A:0x"));
+  eventLine.appendHex(address);
+  eventLine.append(F(" | C:0x"));
+  eventLine.appendHex(command);
 
   if (SHOW_RAW_DATA) {
-    Serial.print(F(" | Raw:0x"));
-    printHex(rawValue, 8);
+    eventLine.append(F(" | Raw:0x"));
+    eventLine.appendHex(rawValue, 8);
   }
 
-  Serial.print(F(" | "));
-  Serial.print(bits);
-  Serial.print(F(" bits"));
+  eventLine.append(F(" | "));
+  eventLine.appendDecimal(bits);
+  eventLine.append(F(" bits"));
 
   if (isRepeat) {
-    Serial.print(F(" | REPEAT"));
+    eventLine.append(F(" | REPEAT"));
   }
 
   // Timing info
   if (lastSignalTime > 0) {
-    Serial.print(F(" | +"));
-    Serial.print(currentTime - lastSignalTime);
-    Serial.print(F("ms"));
+    eventLine.append(F(" | +"));
+    eventLine.appendDecimal((currentTime - lastSignalTime) / 1000);
+    eventLine.append(F("ms"));
   }
 
-  Serial.println();
+  lastSignalTime = currentTime;
+
+  // TX ring saturated - drop the whole event (counted by txRing)
+  if (!queueEventLine()) {
+    return;
+  }
 
   // Diagnostic warnings
   if (bits == 0) {
-    Serial.println(F("  ^ WARNING: 0 bits received - possible noise or interference"));
+    eventLine.clear();
+    eventLine.append(F("  ^ WARNING: 0 bits received - possible noise or interference"));
+    queueEventLine();
   }
-  if (protocol == "UNKNOWN") {
-    Serial.println(F("  ^ UNKNOWN protocol - may need raw timing analysis"));
+  if (protocol == UNKNOWN) {
+    eventLine.clear();
+    eventLine.append(F("  ^ UNKNOWN protocol - may need raw timing analysis (RAW:ON)"));
+    queueEventLine();
   }
-  if (address == 0 && command == 0 && protocol != "UNKNOWN") {
-    Serial.println(F("  ^ Both address and command are 0 - unusual for this protocol"));
+  if (address == 0 && command == 0 && protocol != UNKNOWN) {
+    eventLine.clear();
+    eventLine.append(F("  ^ Both address and command are 0 - unusual for this protocol"));
+    queueEventLine();
   }
 
-  lastSignalTime = currentTime;
+  // Periodic statistics - less frequent to reduce overhead. Repeats are
+  // counted but never reach here, so check the distance, not a multiple.
+  if (totalSignals - statsPrintedAt >= 100) {
+    statsPrintedAt = totalSignals;
+    eventLine.clear();
+    eventLine.append(StringManager::flash(STR_STATS));
+    eventLine.appendDecimal(validSignals);
+    eventLine.append('/');
+    eventLine.appendDecimal(totalSignals);
+    eventLine.append(StringManager::flash(STR_VALID_SIGNALS));
+    eventLine.appendDecimal((validSignals * 100) / totalSignals);
+    eventLine.append(StringManager::flash(STR_SUCCESS_RATE));
+    if (irEvents.overflowCount() > 0) {
+      eventLine.append(F(", "));
+      eventLine.appendDecimal(irEvents.overflowCount());
+      eventLine.append(F(" frames lost"));
+    }
+    if (txRing.droppedCount() > 0) {
+      eventLine.append(F(", "));
+      eventLine.appendDecimal(txRing.droppedCount());
+      eventLine.append(F(" lines dropped"));
+    }
+    eventLine.append(']');
+    queueEventLine();
+  }
+}
+
+// Print simple Flipper-compatible output - one queued line, never blocks
+void printFlipperOutput(uint8_t protocol, uint16_t address, uint16_t command) {
+  eventLine.clear();
+  eventLine.append(getFlipperProtocolName(protocol));
+  eventLine.append(F(", A:0x"));
+  eventLine.appendHex(address);
+  eventLine.append(F(", C:0x"));
+  eventLine.appendHex(command);
+  queueEventLine();
+}
+
+// Copy the receiver's mark/space buffer into a raw burst. Must run before
+// resume() - the buffer is reused by the next capture.
+void streamRawTimings() {
+  uint8_t flags = (IrReceiver.decodedIRData.flags & IRDATA_FLAGS_IS_REPEAT) ? RAW_FLAG_REPEAT : 0;
+  if (!rawStream.beginBurst(MICROS_PER_TICK, flags)) {
+    return;
+  }
+  const irparams_struct* params = IrReceiver.decodedIRData.rawDataPtr;
+  // rawbuf[0] is the gap before the frame
+  for (IRRawlenType i = 1; i < params->rawlen; i++) {
+    rawStream.addDuration(params->rawbuf[i]);
+  }
+  rawStream.endBurst();
+}
+
+// Scheduler task: capture a decoded IR frame and re-arm the receiver at once
+void pollIR() {
+  if (IrReceiver.decode()) {
+    IREvent event;
+    event.timestamp = micros();
+    event.protocol = IrReceiver.decodedIRData.protocol;
+    event.flags = IrReceiver.decodedIRData.flags;
+    event.bits = IrReceiver.decodedIRData.numberOfBits;
+    event.address = IrReceiver.decodedIRData.address;
+    event.command = IrReceiver.decodedIRData.command;
+    event.rawData = IrReceiver.decodedIRData.decodedRawData;
+    irEvents.push(event);
+
+    if (rawStream.wants(event.protocol == UNKNOWN)) {
+      streamRawTimings();
+    }
 
-  // Periodic statistics - less frequent to reduce overhead
-  if (totalSignals % 100 == 0) {
-    Serial.print(F("  [Stats: "));
-    Serial.print(validSignals);
-    Serial.print('/');
-    Serial.print(totalSignals);
-    Serial.print(F(" valid signals, "));
-    Serial.print((validSignals * 100) / totalSignals);
-    Serial.println(F("% success rate]"));
+    // Enable receiving of the next IR signal before any slow work
+    IrReceiver.resume();
   }
 }
 
-// Print simple Flipper-compatible output - optimized
-void printFlipperOutput(String protocol, uint16_t address, uint16_t command) {
-  Serial.print(protocol);
-  Serial.print(F(", A:0x"));
-  printHex(address);
-  Serial.print(F(", C:0x"));
-  printHex(command);
-  Serial.println();
+// Run a learned action - no host round trip
+void runMacro(uint8_t index) {
+  char action[MACRO_ACTION_MAX];
+  IRMacros::readAction(index, action);
+  dispatchCommand(action, commandRoutes, NUM_COMMAND_ROUTES);
 }
 
-void loop() {
-  // Update LED animations
-  ledAnimations.update();
+// Hold summaries replace the per-repeat lines: in debug mode when repeats
+// are shown (CFG:VERB bit 0), otherwise after HOLD:ON
+bool wantHoldReports() {
+  return BuildProfile::debug(DEBUG_MODE) ? SHOW_REPEATS : holdTracker.reportsOn();
+}
 
-  // Process any incoming serial commands for display and LED
-  processSerialCommand();
+// "NEC, A:0x04, C:0x08, HOLD:1000ms, N:10" for the button being held
+void printHoldEvent(const __FlashStringHelper* label) {
+  eventLine.clear();
+  eventLine.append(getFlipperProtocolName(holdTracker.heldProtocol()));
+  eventLine.append(F(", A:0x"));
+  eventLine.appendHex(holdTracker.heldAddress());
+  eventLine.append(F(", C:0x"));
+  eventLine.appendHex(holdTracker.heldCommand());
+  eventLine.append(F(", "));
+  eventLine.append(label);
+  eventLine.append(':');
+  eventLine.appendDecimal(holdTracker.heldMillis());
+  eventLine.append(F("ms, N:"));
+  eventLine.appendDecimal(holdTracker.heldFrames());
+  queueEventLine();
+}
 
-  // Check if we received IR data
-  if (IrReceiver.decode()) {
+void releaseHold() {
+  if (wantHoldReports()) {
+    printHoldEvent(F("RELEASE"));
+  }
+  holdTracker.release();
+}
 
-    // Extract all signal information
-    String protocol = getFlipperProtocolName(IrReceiver.getProtocolString());
-    uint16_t address = IrReceiver.decodedIRData.address;
-    uint16_t command = IrReceiver.decodedIRData.command;
-    uint32_t rawValue = IrReceiver.decodedIRData.decodedRawData;
-    uint8_t bits = IrReceiver.decodedIRData.numberOfBits;
-    bool isRepeat = (IrReceiver.decodedIRData.flags & IRDATA_FLAGS_IS_REPEAT);
+// Filter and print one captured IR frame
+void handleIREvent(const IREvent& event) {
+  // Extract all signal information - protocol stays an id until print time
+  uint8_t protocol = event.protocol;
+  uint16_t address = event.address;
+  uint16_t command = event.command;
+  uint32_t rawValue = event.rawData;
+  uint8_t bits = event.bits;
+  bool isRepeat = (event.flags & IRDATA_FLAGS_IS_REPEAT);
+
+  // Filter out noise: UNKNOWN protocols with zero address and command
+  bool isNoise = (protocol == UNKNOWN && address == 0 && command == 0);
+  
+  // Also filter out signals with 0 bits (usually noise)
+  if (bits == 0) {
+    isNoise = true;
+  }
 
-    // Filter out noise: UNKNOWN protocols with zero address and command
-    bool isNoise = (protocol == "UNKNOWN" && address == 0 && command == 0);
-    
-    // Also filter out signals with 0 bits (usually noise)
-    if (bits == 0) {
-      isNoise = true;
+  if (isNoise) {
+    if (BuildProfile::debug(DEBUG_MODE) && !isRepeat) {
+      // In debug mode, show filtered noise signals with a simple indicator
+      eventLine.clear();
+      eventLine.append(StringManager::flash(STR_NOISE_FILTERED));
+      queueEventLine();
     }
+    return;
+  }
 
-    // Only process valid signals (not noise, not repeats unless in debug mode)
-    bool shouldProcess = !isNoise && (!isRepeat || (DEBUG_MODE && SHOW_REPEATS));
-
-    if (shouldProcess) {
-      if (DEBUG_MODE) {
-        // Detailed debug output
-        printDebugInfo(protocol, address, command, rawValue, bits, isRepeat);
-      } else {
-        // Simple Flipper-compatible output (skip repeats)
-        if (!isRepeat) {
-          printFlipperOutput(protocol, address, command);
-        }
+  // Count before hold tracking swallows the repeats
+  totalSignals++;
+  if (!isRepeat) {
+    validSignals++;
+  }
+
+  // A held button is one press, then periodic summaries and a release -
+  // repeats themselves are never printed
+  if (holdTracker.endsHold(protocol, address, command, event.timestamp)) {
+    releaseHold();
+  }
+  HoldEvent hold = holdTracker.track(protocol, address, command, isRepeat, event.timestamp);
+  if (hold == HOLD_SUMMARY && wantHoldReports()) {
+    printHoldEvent(F("HOLD"));
+  }
+  if (hold != HOLD_PRESS) {
+    return;
+  }
+
+  // Learned buttons react locally before the line is even queued;
+  // while LEARN: is armed the press is bound instead. Both reply with
+  // direct writes, so queued output goes out first.
+  bool learning = IRMacros::isLearning();
+  uint8_t macro = learning ? MACRO_NONE : IRMacros::find(protocol, address, command);
+  if (learning || macro != MACRO_NONE) {
+    txRing.drain();
+  }
+  if (!IRMacros::capture(protocol, address, command) && macro != MACRO_NONE) {
+    runMacro(macro);
+  }
+
+  captureHistory.push(protocol, event.flags, address, command, event.timestamp);
+
+  if (BuildProfile::debug(DEBUG_MODE)) {
+    // Detailed debug output
+    printDebugInfo(protocol, address, command, rawValue, bits, isRepeat, event.timestamp);
+  } else if (flipperExport.isLive()) {
+    flipperExport.exportCapture(protocol, address, command);
+  } else {
+    // Simple Flipper-compatible output
+    printFlipperOutput(protocol, address, command);
+  }
+}
+
+// Scheduler task: drain captured IR frames into the output path
+void processIREvents() {
+  IREvent event;
+  while (irEvents.pop(event)) {
+    StatProbe probe(loopStats, STAT_IR_OUTPUT);
+    handleIREvent(event);
+  }
+
+  if (holdTracker.hasExpired(micros())) {
+    releaseHold();
+  }
+}
+
+// Scheduler task: clock the next TM1637 bus phase
+void updateDisplay() {
+  displayController.update();
+}
+
+// Queue replayed history lines while the TX ring has room:
+// "HIST 123, NEC, A:0x04, C:0x08, +120ms" (sequence, gap to the previous capture)
+void pumpHistoryReplay() {
+  while (historyReplaying) {
+    CaptureRecord record;
+    if (!captureHistory.get(historyReplaySequence, record)) {
+      // Overwritten since HIST:LAST - skip ahead to what is still held
+      if ((int16_t)(historyReplaySequence - captureHistory.firstSequence()) < 0 &&
+          (int16_t)(historyReplayEnd - captureHistory.firstSequence()) > 0) {
+        historyReplaySequence = captureHistory.firstSequence();
+        continue;
       }
-    } else if (DEBUG_MODE && isNoise && !isRepeat) {
-      // In debug mode, show filtered noise signals with a simple indicator
-      Serial.println(F("[NOISE FILTERED]"));
+      historyReplaying = false;
+      break;
     }
 
-    // Enable receiving of the next IR signal
-    IrReceiver.resume();
+    eventLine.clear();
+    eventLine.append(F("HIST "));
+    eventLine.appendDecimal(historyReplaySequence);
+    eventLine.append(F(", "));
+    eventLine.append(getFlipperProtocolName(record.protocol));
+    eventLine.append(F(", A:0x"));
+    eventLine.appendHex(record.address);
+    eventLine.append(F(", C:0x"));
+    eventLine.appendHex(record.command);
+    eventLine.append(F(", +"));
+    eventLine.appendDecimal(record.deltaMillis);
+    eventLine.append(F("ms"));
+    eventLine.appendNewline();
+    if (eventLine.size() > txRing.freeSpace()) {
+      return; // Wait for the UART to drain
+    }
+    txRing.enqueue(eventLine);
+
+    historyReplaySequence++;
+    if (historyReplaySequence == historyReplayEnd) {
+      historyReplaying = false;
+    }
+  }
+}
+
+// Scheduler task: feed queued output to the UART
+void pumpSerialOutput() {
+  rawStream.pump(txRing);
+  flipperExport.pump();
+  pumpHistoryReplay();
+  txRing.pump();
+}
+
+// Scheduler task: advance LED, display-effect and marquee state on one clock read
+void updateAnimations() {
+  StatProbe probe(loopStats, STAT_ANIMATION_UPDATE);
+  sceneEngine.update();
+}
+
+// Strip builds only: the push masks interrupts for the whole frame, so it
+// waits until the receiver is not in the middle of capturing a frame and
+// the RX line has gone quiet (a byte still unread, or a line or frame only
+// partly received, counts as just arrived)
+void pushLEDStrip() {
+  // The rest of a half-received line or frame is due any moment
+  bool rxExpected = Serial.available() > 0 || commandIndex > 0 || frameParser.isActive();
+  unsigned long rxQuiet = rxExpected ? 0 : micros() - lastSerialRxMicros;
+  LEDStrip::show(IrReceiver.isIdle(), rxQuiet);
+}
+
+#if ENABLE_IDLE_SLEEP
+// Nothing animating, queued or mid-decode - the CPU can stop until the next
+// interrupt. Every task period is <= 1ms, so the Timer0 tick that wakes us
+// also covers the next scheduler deadline.
+bool canIdleSleep() {
+  return !ledAnimations.isAnimating() && !displayAnimations.isAnimating() &&
+         !displayController.isScrolling() && displayController.isIdle() &&
+         irEvents.isEmpty() && txRing.isEmpty() && !rawStream.isPending() &&
+         !flipperExport.isBusy() && !historyReplaying && !frameParser.isActive() &&
+         Serial.available() == 0 && IrReceiver.isIdle();
+}
+#endif
+
+void loop() {
+  MemoryMonitor::sampleHeap();
+
+  {
+    StatProbe probe(loopStats, STAT_LOOP);
+    scheduler.run();
   }
 
-  // Reduced delay for better responsiveness
-  delay(10);
+#if ENABLE_IDLE_SLEEP
+  if (canIdleSleep()) {
+    // The 50us receive timer would wake us constantly; the IR pin-change
+    // wake replaces it while asleep. Crediting the sleep to the IR gap
+    // counter lets the mark that woke us start a frame.
+    IrReceiver.stop();
+    unsigned long sleptMicros = IdleSleep::sleep();
+    IrReceiver.start(sleptMicros);
+    return;
+  }
+#endif
+
+  // Idle until the earliest task deadline instead of a fixed delay
+  unsigned long idleMicros = scheduler.timeUntilNextDeadline();
+  if (idleMicros > 0) {
+    delayMicroseconds(idleMicros);
+  }
 }
@@ -0,0 +1,73 @@
+/*
+ * HostBench.cpp - Native replay benchmark for the dancemore_ir sketch
+ *
+ * Builds the whole sketch against the host core, boots it, sends
+ * BENCH:REPLAY down the emulated serial line and runs loop() until the
+ * suite finishes. BENCH lines go to stdout as the sketch prints them,
+ * followed by the core's own counters. Pass -v to see every serial line.
+ *
+ * Exit status is 0 only if the suite ran to "BENCH end".
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "HostCore.h"
+
+#include "../dancemore_ir.ino"
+
+#define HOST_BENCH_TIMEOUT_MS 60000UL
+
+static bool verbose = false;
+static bool benchFinished = false;
+
+static void onSerialLine(const char* line) {
+  if (strncmp(line, "BENCH ", 6) == 0) {
+    puts(line);
+    if (strcmp(line, "BENCH end") == 0) {
+      benchFinished = true;
+    }
+  } else if (verbose) {
+    puts(line);
+  }
+}
+
+int main(int argc, char** argv) {
+  verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+
+  // stdio's own buffer would otherwise be the first allocation we count
+  static char stdoutBuffer[BUFSIZ];
+  setvbuf(stdout, stdoutBuffer, _IOLBF, sizeof(stdoutBuffer));
+
+  HostCore::setLineSink(onSerialLine);
+  HostCore::attachTM1637(CLK, DIO);
+
+  setup();
+  uint32_t bootFrames = HostCore::tm1637Frames;
+  uint32_t bootBytes = HostCore::tm1637Bytes;
+  uint32_t bootSegments = HostCore::tm1637SegmentBytes;
+  uint32_t bootPwm = HostCore::analogWriteCount;
+  uint32_t bootAllocations = HostCore::mallocCount;
+
+  HostCore::feedSerial("BENCH:REPLAY\n");
+  unsigned long started = millis();
+  while (!benchFinished && millis() - started < HOST_BENCH_TIMEOUT_MS) {
+    loop();
+  }
+
+  // Everything the replay pushed through the mock core
+  uint32_t frames = HostCore::tm1637Frames - bootFrames;
+  uint32_t bytes = HostCore::tm1637Bytes - bootBytes;
+  printf("HOST analogWrite=%lu\n", (unsigned long)(HostCore::analogWriteCount - bootPwm));
+  printf("HOST tm1637 frames=%lu bytes=%lu segments=%lu bytes/frame=%.2f\n",
+         (unsigned long)frames, (unsigned long)bytes,
+         (unsigned long)(HostCore::tm1637SegmentBytes - bootSegments),
+         frames ? (double)bytes / frames : 0.0);
+  printf("HOST mallocs=%lu serial=%lu\n", (unsigned long)(HostCore::mallocCount - bootAllocations),
+         (unsigned long)HostCore::serialBytes);
+
+  if (!benchFinished) {
+    fprintf(stderr, "HOST replay did not finish within %lus\n", HOST_BENCH_TIMEOUT_MS / 1000);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,339 @@
+/*
+ * HostCore.cpp - Native stand-in for the Arduino core
+ */
+
+#include <chrono> // Before Arduino.h - its min/max macros break <limits>
+#include <Arduino.h>
+#include <IRremote.h>
+#include <EEPROM.h>
+#include "HostCore.h"
+
+uint32_t HostCore::analogWriteCount = 0;
+uint32_t HostCore::serialBytes = 0;
+uint32_t HostCore::tm1637Frames = 0;
+uint32_t HostCore::tm1637Bytes = 0;
+uint32_t HostCore::tm1637SegmentBytes = 0;
+uint8_t HostCore::tm1637Digits[6];
+uint32_t HostCore::mallocCount = 0;
+
+// Registers - interrupts start enabled, as after the Arduino core's init()
+volatile uint8_t PORTD, PCICR, PCMSK0, PCMSK1, PCMSK2, PCIFR, MCUSR, WDTCSR,
+    TIMSK0, OCR0B, TCCR0A, TCCR0B, TCCR1A, TCCR1B, TIFR1, TIMSK1, ADCSRA, PRR,
+    SPH, SPL, GPIOR0, UCSR0A;
+volatile uint8_t SREG = 0x80;
+volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1, SP;
+
+// Linker symbols MemoryMonitor and the benchmark read on the target
+char __bss_end, __heap_start; // __data_start comes from the C runtime
+char* __brkval = 0;
+
+HardwareSerial Serial;
+IRrecv IrReceiver;
+EEPROMClass EEPROM;
+
+// Counting allocator - glibc's own entry points do the work
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+
+extern "C" void* malloc(size_t size) {
+  HostCore::mallocCount++;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  HostCore::mallocCount++;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+  HostCore::mallocCount++;
+  return __libc_realloc(pointer, size);
+}
+
+// Benchmark.h picks this up as the allocation counter
+uint32_t benchAllocationCount() {
+  return HostCore::mallocCount;
+}
+
+// Time - wall clock plus whatever delay() skipped
+extern "C" void TIMER0_COMPB_vect(void);
+
+static unsigned long skippedMicros = 0;
+static unsigned long lastTimer0Tick = 0;
+static bool inInterrupt = false;
+
+static unsigned long wallMicros() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+// Timer0 overflows every 1024us; run the compare B vector for each one that
+// passed while interrupts were enabled, as the hardware would
+static void serviceTimer0(unsigned long now) {
+  unsigned long tick = now / 1024;
+  if (tick - lastTimer0Tick > 8) {
+    lastTimer0Tick = tick - 8; // A long stall only leaves one flag pending on the target
+  }
+  while (lastTimer0Tick < tick) {
+    lastTimer0Tick++;
+    if ((SREG & 0x80) && (TIMSK0 & _BV(OCIE0B)) && !inInterrupt) {
+      inInterrupt = true;
+      TIMER0_COMPB_vect();
+      inInterrupt = false;
+    }
+  }
+}
+
+unsigned long micros() {
+  unsigned long now = wallMicros() + skippedMicros;
+  serviceTimer0(now);
+  return now;
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+  skippedMicros += ms * 1000UL;
+  micros();
+}
+
+void delayMicroseconds(unsigned int us) {
+  skippedMicros += us;
+  micros();
+}
+
+// TM1637 module model. Both lines are open-drain: OUTPUT with the latch low
+// pulls the line down, INPUT lets the pull-up take it high.
+static const uint8_t HOST_PINS = 32;
+static uint8_t pinModes[HOST_PINS];
+static uint8_t pinLatches[HOST_PINS];
+static uint8_t tmClk = 0xFF, tmDio = 0xFF;
+static uint8_t clkLevel = 1, dioLevel = 1;
+static bool tmInFrame = false;
+static uint8_t tmBitCount = 0;
+static uint8_t tmByte = 0;
+static uint8_t tmByteIndex = 0;
+static uint8_t tmCommand = 0;
+
+static uint8_t lineLevel(uint8_t pin) {
+  return (pinModes[pin] == OUTPUT && pinLatches[pin] == LOW) ? 0 : 1;
+}
+
+static void tm1637ByteDone() {
+  HostCore::tm1637Bytes++;
+  if (tmByteIndex == 0) {
+    tmCommand = tmByte;
+  } else if ((tmCommand & 0xC0) == 0xC0) {
+    HostCore::tm1637SegmentBytes++;
+    uint8_t grid = (tmCommand & 0x07) + tmByteIndex - 1; // Address auto-increments
+    if (grid < sizeof(HostCore::tm1637Digits)) {
+      HostCore::tm1637Digits[grid] = tmByte;
+    }
+  }
+  tmByteIndex++;
+}
+
+static void tm1637LinesChanged() {
+  if (tmClk >= HOST_PINS || tmDio >= HOST_PINS) {
+    return;
+  }
+  uint8_t clk = lineLevel(tmClk);
+  uint8_t dio = lineLevel(tmDio);
+
+  if (clk && clkLevel && dio != dioLevel) {
+    if (!dio) { // DIO falls with CLK high: start
+      tmInFrame = true;
+      tmBitCount = 0;
+      tmByteIndex = 0;
+    } else if (tmInFrame) { // DIO rises with CLK high: stop
+      tmInFrame = false;
+      HostCore::tm1637Frames++;
+    }
+  } else if (clk && !clkLevel && tmInFrame) { // CLK rising edge
+    if (tmBitCount < 8) {
+      tmByte = (tmByte >> 1) | (dio ? 0x80 : 0); // LSB first
+      if (++tmBitCount == 8) {
+        tm1637ByteDone();
+      }
+    } else {
+      tmBitCount = 0; // Ninth clock is the module's ACK
+    }
+  }
+  clkLevel = clk;
+  dioLevel = dio;
+}
+
+void HostCore::attachTM1637(uint8_t clkPin, uint8_t dioPin) {
+  tmClk = clkPin;
+  tmDio = dioPin;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= HOST_PINS) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) pinLatches[pin] = HIGH;
+  if (pin == tmClk || pin == tmDio) tm1637LinesChanged();
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin >= HOST_PINS) return;
+  pinLatches[pin] = value;
+  if (pin == tmClk || pin == tmDio) tm1637LinesChanged();
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= HOST_PINS) return LOW;
+  return lineLevel(pin) ? HIGH : LOW; // Nothing on the board pulls a pin down
+}
+
+void analogWrite(uint8_t pin, int value) {
+  (void)pin;
+  (void)value;
+  HostCore::analogWriteCount++;
+}
+
+long random(long limit) {
+  return (limit <= 0) ? 0 : rand() % limit;
+}
+
+long random(long low, long high) {
+  return (high <= low) ? low : low + rand() % (high - low);
+}
+
+void randomSeed(unsigned long seed) {
+  srand((unsigned)seed);
+}
+
+// Number formatting - same digits as avr-libc
+static char* formatUnsigned(unsigned long value, char* out, int base) {
+  char digits[sizeof(unsigned long) * 8 + 1];
+  uint8_t n = 0;
+  do {
+    uint8_t digit = value % base;
+    digits[n++] = (digit < 10) ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value != 0);
+
+  char* p = out;
+  while (n > 0) *p++ = digits[--n];
+  *p = '\0';
+  return out;
+}
+
+char* ultoa(unsigned long value, char* out, int base) {
+  return formatUnsigned(value, out, base);
+}
+
+char* utoa(unsigned int value, char* out, int base) {
+  return formatUnsigned(value, out, base);
+}
+
+char* ltoa(long value, char* out, int base) {
+  if (value < 0 && base == 10) {
+    out[0] = '-';
+    formatUnsigned(-(unsigned long)value, out + 1, base);
+    return out;
+  }
+  return formatUnsigned((unsigned long)value, out, base);
+}
+
+char* itoa(int value, char* out, int base) {
+  return ltoa(value, out, base);
+}
+
+// Print
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    write(buffer[i]);
+  }
+  return size;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+  char text[sizeof(unsigned long) * 8 + 1];
+  formatUnsigned(value, text, base);
+  for (char* p = text; *p; p++) {
+    if (*p >= 'a') *p -= 'a' - 'A'; // Print uses upper-case hex digits
+  }
+  return write(text);
+}
+
+size_t Print::print(long value, int base) {
+  if (base == 10 && value < 0) {
+    return write((uint8_t)'-') + printNumber(-(unsigned long)value, base);
+  }
+  // Negative hex prints as the target's 32-bit two's complement
+  return printNumber((base == 10) ? (unsigned long)value : (unsigned long)(uint32_t)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return printNumber(value, base);
+}
+
+// Serial - RX from a ring the harness fills, TX split into lines
+static char rxBuffer[4096];
+static uint16_t rxHead = 0, rxTail = 0;
+
+static HostCore::LineSink lineSink = nullptr;
+static char txLine[512];
+static uint16_t txLength = 0;
+
+void HostCore::setLineSink(LineSink sink) {
+  lineSink = sink;
+}
+
+void HostCore::feedSerial(const char* text) {
+  while (*text) {
+    uint16_t next = (rxHead + 1) % sizeof(rxBuffer);
+    if (next == rxTail) return; // Full - the UART would overrun too
+    rxBuffer[rxHead] = *text++;
+    rxHead = next;
+  }
+}
+
+int HardwareSerial::available() {
+  return (rxHead + sizeof(rxBuffer) - rxTail) % sizeof(rxBuffer);
+}
+
+int HardwareSerial::peek() {
+  return (rxHead == rxTail) ? -1 : (uint8_t)rxBuffer[rxTail];
+}
+
+int HardwareSerial::read() {
+  int c = peek();
+  if (c >= 0) rxTail = (rxTail + 1) % sizeof(rxBuffer);
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  HostCore::serialBytes++;
+  if (c == '\n') {
+    if (txLength > 0 && txLine[txLength - 1] == '\r') txLength--;
+    txLine[txLength] = '\0';
+    if (lineSink != nullptr) lineSink(txLine);
+    txLength = 0;
+  } else if (txLength < sizeof(txLine) - 1) {
+    txLine[txLength++] = (char)c;
+  }
+  return 1;
+}
+
+// IRremote's protocol names for the ids the sketch reports
+const __FlashStringHelper* getProtocolString(decode_type_t protocol) {
+  switch (protocol) {
+    case NEC: return F("NEC");
+    case NEC2: return F("NEC2");
+    case SONY: return F("Sony");
+    case SAMSUNG: return F("Samsung");
+    case RC5: return F("RC5");
+    case RC6: return F("RC6");
+    case PANASONIC: return F("Panasonic");
+    case JVC: return F("JVC");
+    case LG: return F("LG");
+    default: return F("UNKNOWN");
+  }
+}
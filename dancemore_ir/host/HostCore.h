@@ -0,0 +1,44 @@
+/*
+ * HostCore.h - Native (x86) stand-in for the Arduino core
+ *
+ * Backs the stubs in host/stubs: a real-time micros() with delay() as a
+ * virtual time skip, Timer0's compare interrupt (ColorPipeline) serviced
+ * from micros() while the I bit is set, Serial RX fed by the harness and TX
+ * handed over line by line, and a model of a TM1637 module that decodes
+ * the bit-banged bus from the pin changes.
+ *
+ * Counters for the benchmark: analogWrite() calls, decoded TM1637 frames,
+ * bytes and segment bytes, and malloc/calloc/realloc calls. The decoded
+ * digit contents are kept too, for the display checks.
+ */
+
+#ifndef HOST_CORE_H
+#define HOST_CORE_H
+
+#include <stdint.h>
+
+class HostCore {
+public:
+  typedef void (*LineSink)(const char* line);
+
+  // Serial TX arrives here one line at a time, without the "\r\n"
+  static void setLineSink(LineSink sink);
+
+  // Queue bytes for Serial.read()
+  static void feedSerial(const char* text);
+
+  // Decode the TM1637 bus on these pins (open-drain, as TM1637Bus drives it)
+  static void attachTM1637(uint8_t clkPin, uint8_t dioPin);
+
+  static uint32_t analogWriteCount;
+  static uint32_t serialBytes;
+  static uint32_t tm1637Frames;       // start..stop transactions
+  static uint32_t tm1637Bytes;        // every byte clocked out
+  static uint32_t tm1637SegmentBytes; // bytes after an address command
+  static uint32_t mallocCount;
+
+  // Segment bytes the module latched, by grid address (C0H..C5H)
+  static uint8_t tm1637Digits[6];
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * HostDisplayCheck.cpp - Native check of DISP: rendering on one module
+ *
+ * Boots the sketch with its stock single-display wiring, sends DISP:
+ * commands down the emulated serial line and compares the digits the
+ * TM1637 model latched with what the command must show. DISP:1:30 is
+ * the case that matters: with one module it is the text "1:30", as it
+ * was before chained modules existed, not module 1 showing "30".
+ *
+ * Exit status is 0 only if every case matches.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "HostCore.h"
+
+#include "../dancemore_ir.ino"
+
+// Long enough for the scheduler to clock a full frame out on the bus
+#define HOST_CHECK_SETTLE_MS 100UL
+
+static void runFor(unsigned long ms) {
+  unsigned long started = millis();
+  while (millis() - started < ms) {
+    loop();
+  }
+}
+
+static bool expectText(const char* command, const char* text) {
+  char line[32];
+  snprintf(line, sizeof(line), "%s\n", command);
+  HostCore::feedSerial(line);
+  runFor(HOST_CHECK_SETTLE_MS);
+
+  // One segment byte per character, blanks after the end of the text
+  size_t length = strlen(text);
+  bool match = true;
+  for (uint8_t digit = 0; digit < TM1637_DIGITS; digit++) {
+    uint8_t expected = (digit < length) ? DisplayController::encodeChar(text[digit]) : 0;
+    if (HostCore::tm1637Digits[digit] != expected) {
+      match = false;
+    }
+  }
+  printf("HOST %s -> %02X %02X %02X %02X %s\n", command,
+         HostCore::tm1637Digits[0], HostCore::tm1637Digits[1],
+         HostCore::tm1637Digits[2], HostCore::tm1637Digits[3], match ? "ok" : "MISMATCH");
+  return match;
+}
+
+int main() {
+  HostCore::attachTM1637(CLK, DIO);
+  setup();
+  runFor(HOST_CHECK_SETTLE_MS);
+
+  bool ok = true;
+  ok &= expectText("DISP:1:30", "1:30");
+  ok &= expectText("DISP:HELO", "HELO");
+  ok &= expectText("DISP:1:AB", "1:AB");
+  return ok ? 0 : 1;
+}
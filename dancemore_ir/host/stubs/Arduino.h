@@ -0,0 +1,115 @@
+/*
+ * Arduino.h - Host stub of the Arduino core (see host/HostCore.cpp)
+ *
+ * Just enough of the AVR core for the sketch to build natively: flash is
+ * ordinary memory, Serial is captured by the host harness and the pin
+ * functions feed the counters and the TM1637 model in HostCore.
+ */
+
+#ifndef ARDUINO_H_HOST_STUB
+#define ARDUINO_H_HOST_STUB
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "avr/pgmspace.h"
+#include "avr/io.h"
+#include "avr/interrupt.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+#define FPSTR(p) ((const __FlashStringHelper*)(p))
+
+#define HEX 16
+#define DEC 10
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LOW 0
+#define HIGH 1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+long random(long limit);
+long random(long low, long high);
+void randomSeed(unsigned long seed);
+
+char* itoa(int value, char* out, int base);
+char* ltoa(long value, char* out, int base);
+char* utoa(unsigned int value, char* out, int base);
+char* ultoa(unsigned long value, char* out, int base);
+
+// Every pin sits on PORTD; only the IdleSleep pin-change setup looks at it
+#define digitalPinToPort(p) (p)
+#define digitalPinToBitMask(p) (1 << ((p) & 7))
+#define portOutputRegister(p) (&PORTD)
+#define digitalPinToPCICR(p) (&PCICR)
+#define digitalPinToPCICRbit(p) (2)
+#define digitalPinToPCMSK(p) (&PCMSK2)
+#define digitalPinToPCMSKbit(p) ((p) & 7)
+#define NOT_A_PIN 0
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+class Print {
+private:
+  size_t printNumber(unsigned long value, int base);
+
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const __FlashStringHelper* str) { return print((const char*)str); }
+  size_t print(const char* str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+
+  size_t println() { return write((const uint8_t*)"\r\n", 2); }
+  template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+
+  virtual void flush() {}
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int availableForWrite() override { return 63; } // Host "UART" never backs up
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
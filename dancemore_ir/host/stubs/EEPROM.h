@@ -0,0 +1,34 @@
+/*
+ * EEPROM.h - Host stub: 1KB of erased (0xFF) EEPROM in RAM
+ */
+
+#ifndef EEPROM_H_HOST_STUB
+#define EEPROM_H_HOST_STUB
+
+#include <stdint.h>
+#include <string.h>
+
+#define HOST_EEPROM_SIZE 1024
+
+struct EEPROMClass {
+  uint8_t cells[HOST_EEPROM_SIZE];
+
+  EEPROMClass() { memset(cells, 0xFF, sizeof(cells)); }
+  uint8_t read(int address) { return cells[address]; }
+  void write(int address, uint8_t value) { cells[address] = value; }
+  void update(int address, uint8_t value) { cells[address] = value; }
+  uint16_t length() { return HOST_EEPROM_SIZE; }
+
+  template <typename T> T& get(int address, T& value) {
+    memcpy(&value, cells + address, sizeof(T));
+    return value;
+  }
+  template <typename T> const T& put(int address, const T& value) {
+    memcpy(cells + address, &value, sizeof(T));
+    return value;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
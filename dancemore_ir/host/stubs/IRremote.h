@@ -0,0 +1,60 @@
+/*
+ * IRremote.h - Host stub of the IRremote receiver API the sketch uses
+ *
+ * The receiver never decodes anything on its own; the benchmark feeds
+ * recorded IREvents straight into handleIREvent() instead.
+ */
+
+#ifndef IRREMOTE_H_HOST_STUB
+#define IRREMOTE_H_HOST_STUB
+
+#include <Arduino.h>
+
+typedef enum {
+  UNKNOWN = 0, PULSE_WIDTH, PULSE_DISTANCE, APPLE, DENON, JVC, LG, LG2, NEC, NEC2,
+  ONKYO, PANASONIC, KASEIKYO, KASEIKYO_DENON, KASEIKYO_SHARP, KASEIKYO_JVC,
+  KASEIKYO_MITSUBISHI, RC5, RC6, SAMSUNG, SAMSUNGLG, SAMSUNG48, SHARP, SONY,
+  BANG_OLUFSEN, BOSEWAVE, LEGO_PF, MAGIQUEST, WHYNTER, FAST
+} decode_type_t;
+
+#define IRDATA_FLAGS_IS_REPEAT 0x01
+#define ENABLE_LED_FEEDBACK true
+#define MICROS_PER_TICK 50
+#define RAW_BUFFER_LENGTH 100
+
+typedef uint16_t IRRawbufType;
+typedef uint8_t IRRawlenType;
+
+struct irparams_struct {
+  IRRawlenType rawlen;
+  IRRawbufType rawbuf[RAW_BUFFER_LENGTH];
+};
+
+struct IRData {
+  decode_type_t protocol;
+  uint16_t address;
+  uint16_t command;
+  uint32_t decodedRawData;
+  uint16_t numberOfBits;
+  uint8_t flags;
+  irparams_struct* rawDataPtr;
+};
+
+class IRrecv {
+public:
+  IRData decodedIRData;
+
+  void begin(uint8_t pin, bool ledFeedback = false) { (void)pin; (void)ledFeedback; }
+  bool decode() { return false; }
+  void resume() {}
+  bool isIdle() { return true; }
+  void start() {}
+  void start(uint32_t microsecondsToAddToGapCounter) { (void)microsecondsToAddToGapCounter; }
+  void stop() {}
+};
+
+extern IRrecv IrReceiver;
+
+const __FlashStringHelper* getProtocolString(decode_type_t protocol);
+
+#endif
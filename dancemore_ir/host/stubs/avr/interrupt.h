@@ -0,0 +1,17 @@
+/*
+ * avr/interrupt.h - Host stub: the I bit lives in the SREG variable
+ *
+ * HostCore calls the Timer0 compare vector itself while the bit is set.
+ */
+
+#ifndef INTERRUPT_H_HOST_STUB
+#define INTERRUPT_H_HOST_STUB
+
+#include "avr/io.h"
+
+#define ISR(vector) extern "C" void vector(void)
+
+inline void cli() { SREG &= ~0x80; }
+inline void sei() { SREG |= 0x80; }
+
+#endif
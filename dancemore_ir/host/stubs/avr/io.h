@@ -0,0 +1,27 @@
+/*
+ * avr/io.h - Host stub: ATmega328 registers as plain variables
+ */
+
+#ifndef IO_H_HOST_STUB
+#define IO_H_HOST_STUB
+
+#include <stdint.h>
+
+extern volatile uint8_t PORTD, PCICR, PCMSK0, PCMSK1, PCMSK2, PCIFR, MCUSR, WDTCSR,
+    TIMSK0, OCR0B, TCCR0A, TCCR0B, TCCR1A, TCCR1B, TIFR1, TIMSK1, SREG, ADCSRA, PRR,
+    SPH, SPL, GPIOR0, UCSR0A;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1, SP;
+
+#define _BV(b) (1 << (b))
+
+enum {
+  PCIE0 = 0, PCIE1 = 1, PCIE2 = 2, PCIF2 = 2, PCINT16 = 0, PCINT18 = 2,
+  DOR0 = 3, OCIE0B = 2, TOV1 = 0, OCF1A = 1, OCF1B = 2, ICF1 = 5, TOIE1 = 0, CS10 = 0,
+  PORF = 0, EXTRF = 1, BORF = 2, WDRF = 3,
+  WDP0 = 0, WDP1 = 1, WDP2 = 2, WDE = 3, WDCE = 4, WDP3 = 5, WDIE = 6,
+  ADEN = 7, PRADC = 0, PRSPI = 2, PRTIM1 = 3, PRTWI = 7
+};
+
+#define RAMEND 0x8FF
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * avr/pgmspace.h - Host stub: flash is ordinary memory
+ */
+
+#ifndef PGMSPACE_H_HOST_STUB
+#define PGMSPACE_H_HOST_STUB
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(a) (*(const uint8_t*)(a))
+#define pgm_read_word(a) (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(const uint32_t*)(a))
+#define pgm_read_ptr(a) (*(void* const*)(a))
+
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcat_P strcat
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+#endif
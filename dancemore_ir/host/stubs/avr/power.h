@@ -0,0 +1,15 @@
+/*
+ * avr/power.h - Host stub: no peripherals to gate
+ */
+
+#ifndef POWER_H_HOST_STUB
+#define POWER_H_HOST_STUB
+
+inline void power_adc_disable() {}
+inline void power_adc_enable() {}
+inline void power_spi_disable() {}
+inline void power_spi_enable() {}
+inline void power_twi_disable() {}
+inline void power_twi_enable() {}
+
+#endif
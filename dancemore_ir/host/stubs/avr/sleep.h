@@ -0,0 +1,17 @@
+/*
+ * avr/sleep.h - Host stub: sleeping returns immediately
+ */
+
+#ifndef SLEEP_H_HOST_STUB
+#define SLEEP_H_HOST_STUB
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_PWR_SAVE 3
+
+inline void set_sleep_mode(int mode) { (void)mode; }
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+inline void sleep_cpu() {}
+inline void sleep_mode() {}
+
+#endif
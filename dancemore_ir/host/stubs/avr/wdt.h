@@ -0,0 +1,21 @@
+/*
+ * avr/wdt.h - Host stub: the watchdog never fires
+ */
+
+#ifndef WDT_H_HOST_STUB
+#define WDT_H_HOST_STUB
+
+#define WDTO_15MS 0
+#define WDTO_30MS 1
+#define WDTO_60MS 2
+#define WDTO_120MS 3
+#define WDTO_250MS 4
+#define WDTO_500MS 5
+#define WDTO_1S 6
+#define WDTO_2S 7
+
+inline void wdt_reset() {}
+inline void wdt_enable(int timeout) { (void)timeout; }
+inline void wdt_disable() {}
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * util/atomic.h - Host stub: ATOMIC_BLOCK masks through the SREG variable
+ */
+
+#ifndef ATOMIC_H_HOST_STUB
+#define ATOMIC_H_HOST_STUB
+
+#include "avr/interrupt.h"
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) \
+  for (uint8_t atomicSaved = SREG, atomicOnce = (cli(), 1); atomicOnce; SREG = atomicSaved, atomicOnce = 0)
+
+#endif